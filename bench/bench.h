@@ -0,0 +1,53 @@
+#pragma once
+
+// 各基准程序共用的计时与结果输出
+// 每个结果输出为一行JSON，便于不同版本之间对比
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+namespace bench
+{
+	using Clock = std::chrono::steady_clock;
+
+	// 自构造以来经过的时间
+	struct Timer
+	{
+		Clock::time_point start = Clock::now();
+
+		double seconds() const
+		{
+			return std::chrono::duration<double>(Clock::now() - start).count();
+		}
+	};
+
+	// 本进程的峰值常驻内存(KB)，无法获取时为0
+	inline long peak_rss_kb()
+	{
+#ifndef _WIN32
+		struct rusage usage;
+		if (getrusage(RUSAGE_SELF, &usage) != 0)
+			return 0;
+#ifdef __APPLE__
+		return usage.ru_maxrss / 1024; // macOS以字节为单位
+#else
+		return usage.ru_maxrss;
+#endif
+#else
+		return 0;
+#endif
+	}
+
+	// name: 结果名称；ops: 计时期间完成的操作数；seconds: 墙钟时间
+	inline void report(const std::string &name, double ops, double seconds, long rss_kb = peak_rss_kb())
+	{
+		std::printf("{\"name\":\"%s\",\"ops\":%.0f,\"wall_s\":%.6f,\"ops_per_sec\":%.1f,\"peak_rss_kb\":%ld}\n",
+					name.c_str(), ops, seconds, seconds > 0 ? ops / seconds : 0.0, rss_kb);
+		std::fflush(stdout);
+	}
+}
@@ -0,0 +1,92 @@
+// 比较DictTable与std::map作为Dict存储时的查找、插入耗时
+// 用法: make bench
+
+#include "bench.h"
+#include "Interpreter/DictTable.h"
+#include <map>
+
+using namespace Basic;
+using std::map;
+using DataPtr = shared_ptr<unique_ptr<Data>>;
+using bench::Timer;
+
+static vector<string> make_keys(size_t n)
+{
+	// 模拟配置类脚本中常见的属性名
+	static const char *words[] = {"name", "age", "width", "height", "color", "enabled", "path", "timeout"};
+	vector<string> keys;
+	for (size_t i = 0; i < n; i++)
+		keys.push_back(string(words[i % 8]) + (i < 8 ? "" : "_" + std::to_string(i)));
+	return keys;
+}
+
+static void run(size_t n)
+{
+	const size_t rounds = 2000000 / n + 1;
+	const size_t build_rounds = rounds / 4 + 1;
+	vector<string> keys = make_keys(n);
+	DataPtr value; // 只比较容器本身，值的内容无关紧要
+	size_t found = 0;
+
+	map<string, DataPtr> tree;
+	DictTable table;
+	for (auto &key : keys)
+	{
+		tree[key] = value;
+		table[key] = value;
+	}
+
+	Timer map_find_timer;
+	for (size_t r = 0; r < rounds; r++)
+		for (auto &key : keys)
+			found += tree.find(key) != tree.end();
+	double map_find = map_find_timer.seconds();
+	size_t map_find_ops = rounds * n;
+
+	Timer table_find_timer;
+	for (size_t r = 0; r < rounds; r++)
+		for (auto &key : keys)
+			found += table.find(key) != nullptr;
+	double table_find = table_find_timer.seconds();
+	size_t table_find_ops = rounds * n;
+
+	Timer map_insert_timer;
+	for (size_t r = 0; r < build_rounds; r++)
+	{
+		map<string, DataPtr> m;
+		for (auto &key : keys)
+			m[key] = value;
+		found += m.size();
+	}
+	double map_insert = map_insert_timer.seconds();
+	size_t map_insert_ops = build_rounds * n;
+
+	Timer table_insert_timer;
+	for (size_t r = 0; r < build_rounds; r++)
+	{
+		DictTable t;
+		for (auto &key : keys)
+			t[key] = value;
+		found += t.size();
+	}
+	double table_insert = table_insert_timer.seconds();
+	size_t table_insert_ops = build_rounds * n;
+
+	string suffix = "/" + std::to_string(n);
+	bench::report("dict_table/find/map" + suffix, map_find_ops, map_find);
+	bench::report("dict_table/find/table" + suffix, table_find_ops, table_find);
+	bench::report("dict_table/insert/map" + suffix, map_insert_ops, map_insert);
+	bench::report("dict_table/insert/table" + suffix, table_insert_ops, table_insert);
+
+	// 防止循环被整体优化掉
+	if (found == 0)
+		std::printf("unreachable\n");
+}
+
+int main()
+{
+	for (size_t n : {4, 8, 32, 256, 4096})
+		run(n);
+
+	return 0;
+}
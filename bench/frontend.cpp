@@ -0,0 +1,129 @@
+// 分别测量Lexer::make_tokens、Parser::parse、Interpreter::visit以及字节码编译执行的吞吐量
+// 用法: make bench
+
+#include "bench.h"
+#include "Lexer/Lexer.h"
+#include "Parser/Parser.h"
+#include "Interpreter/Interpreter.h"
+#include "Compiler/Compiler.h"
+#include "VM/VM.h"
+#include "Common/utils.h"
+
+using namespace Basic;
+using bench::Timer;
+
+// Data.cpp中的RUN依赖main.cpp里的实现，基准程序不调用RUN，提供一个空实现以便链接
+std::optional<tuple<DataPtr, shared_ptr<Error>>> Basic::run_file(const string &)
+{
+	return std::nullopt;
+}
+
+// 前端负载：函数定义、控制语句、各类表达式与字面量，重复copies次
+static string make_source(size_t copies)
+{
+	static const char *block =
+		"FUNC area_%zu(w, h) -> w * h + (w - h) ^ 2 / 3\n"
+		"FUNC pick_%zu(items, key)\n"
+		"\tVAR found = []\n"
+		"\tFOR i = 0 TO LEN(items) THEN\n"
+		"\t\tIF items[i] == key AND NOT i > 10 THEN APPEND(found, i) ELIF i == 3 THEN CONTINUE ELSE VAR x = -i\n"
+		"\tEND\n"
+		"\tRETURN found\n"
+		"END\n"
+		"VAR table_%zu = { name: \"row\", size: 12.5, tags: [1, 2, \"three\", [4, 5]] }\n"
+		"# 注释独占一行，行尾注释会连同换行一起跳过\n"
+		"WHILE table_%zu.size > 0 THEN VAR table_%zu.size = table_%zu.size - 1\n";
+
+	string source;
+	char buf[1024];
+	for (size_t i = 0; i < copies; i++)
+	{
+		std::snprintf(buf, sizeof(buf), block, i, i, i, i, i, i);
+		source += buf;
+	}
+	return source;
+}
+
+// 执行负载：不调用内置函数，全局符号表为空也能运行
+static const char *exec_source =
+	"FUNC fib(n)\n"
+	"\tIF n < 2 THEN RETURN n\n"
+	"\tRETURN fib(n - 1) + fib(n - 2)\n"
+	"END\n"
+	"VAR total = 0\n"
+	"FOR i = 0 TO 20000 THEN VAR total = total + i * 2 - 1\n"
+	"fib(16)\n";
+
+static vector<Token> lex(const string &source)
+{
+	return Lexer("<bench>", source).make_tokens();
+}
+
+static void bench_lexer(const string &source, int rounds)
+{
+	size_t tokens = 0;
+	Timer timer;
+	for (int r = 0; r < rounds; r++)
+		tokens += lex(source).size();
+	bench::report("lexer/make_tokens", tokens, timer.seconds());
+}
+
+static void bench_parser(const string &source, int rounds)
+{
+	// 每轮先做词法分析，只对语法分析计时
+	size_t tokens = 0;
+	double seconds = 0;
+	for (int r = 0; r < rounds; r++)
+	{
+		vector<Token> toks = lex(source);
+		tokens += toks.size();
+
+		Timer timer;
+		Parser parser(std::move(toks));
+		parser.parse();
+		seconds += timer.seconds();
+	}
+	bench::report("parser/parse", tokens, seconds);
+}
+
+static void bench_interpreter(int rounds)
+{
+	Parser parser(lex(exec_source));
+	ASTNode *root = parser.parse();
+
+	Timer timer;
+	for (int r = 0; r < rounds; r++)
+	{
+		Context context("<program>");
+		Interpreter interpreter(parser.get_arena());
+		interpreter.visit(root, context);
+	}
+	bench::report("interpreter/visit", rounds, timer.seconds());
+}
+
+static void bench_vm(int rounds)
+{
+	Parser parser(lex(exec_source));
+	shared_ptr<Chunk> chunk = Compiler().compile(parser.parse());
+
+	Timer timer;
+	for (int r = 0; r < rounds; r++)
+	{
+		Context context("<program>");
+		VM vm;
+		vm.run(chunk, context);
+	}
+	bench::report("vm/run", rounds, timer.seconds());
+}
+
+int main()
+{
+	string source = make_source(500);
+
+	bench_lexer(source, 50);
+	bench_parser(source, 50);
+	bench_interpreter(20);
+	bench_vm(20);
+
+	return 0;
+}
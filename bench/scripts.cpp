@@ -0,0 +1,116 @@
+// 用output/basic运行bench/scripts下的脚本，分别记录字节码与树遍历模式的耗时和峰值内存
+// 用法: make bench（在仓库根目录下运行）
+// 可选参数: bench_scripts [解释器路径] [脚本目录] [重复次数]
+
+#include "bench.h"
+#include <filesystem>
+#include <algorithm>
+#include <vector>
+#include <cstdlib>
+
+#ifndef _WIN32
+#include <sys/wait.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+using std::string;
+using std::vector;
+
+#ifndef _WIN32
+// 在子进程中运行一次脚本，丢弃其输出；失败时返回false
+static bool run_once(const string &basic, const string &script, bool tree, double &seconds, long &rss_kb)
+{
+	bench::Timer timer;
+	pid_t pid = fork();
+	if (pid < 0)
+		return false;
+
+	if (pid == 0)
+	{
+		int null_fd = open("/dev/null", O_WRONLY);
+		if (null_fd >= 0)
+		{
+			dup2(null_fd, STDOUT_FILENO);
+			dup2(null_fd, STDERR_FILENO);
+		}
+
+		if (tree)
+			execl(basic.c_str(), basic.c_str(), "-T", "-f", script.c_str(), (char *)nullptr);
+		else
+			execl(basic.c_str(), basic.c_str(), "-f", script.c_str(), (char *)nullptr);
+		_exit(127);
+	}
+
+	int status = 0;
+	struct rusage usage;
+	if (wait4(pid, &status, 0, &usage) < 0)
+		return false;
+
+	seconds = timer.seconds();
+	rss_kb = usage.ru_maxrss;
+#ifdef __APPLE__
+	rss_kb /= 1024;
+#endif
+	return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+#endif
+
+int main(int argc, char *argv[])
+{
+	string basic = argc > 1 ? argv[1] : "output/basic";
+	string dir = argc > 2 ? argv[2] : "bench/scripts";
+	int repeat = argc > 3 ? std::atoi(argv[3]) : 3;
+
+#ifdef _WIN32
+	std::fprintf(stderr, "bench_scripts: not supported on Windows\n");
+	return 0;
+#else
+	vector<fs::path> scripts;
+	std::error_code ec;
+	for (auto &entry : fs::directory_iterator(dir, ec))
+	{
+		if (entry.path().extension() == ".txt")
+			scripts.push_back(entry.path());
+	}
+	std::sort(scripts.begin(), scripts.end());
+
+	if (scripts.empty())
+	{
+		std::fprintf(stderr, "bench_scripts: no scripts found in %s\n", dir.c_str());
+		return 1;
+	}
+
+	int failed = 0;
+	for (auto &script : scripts)
+	{
+		for (bool tree : {false, true})
+		{
+			// 取多次运行中最快的一次，内存取最大值
+			double best = 0;
+			long rss_kb = 0;
+			bool ok = true;
+			for (int r = 0; r < repeat && ok; r++)
+			{
+				double seconds;
+				long rss;
+				ok = run_once(basic, script.string(), tree, seconds, rss);
+				best = r == 0 ? seconds : std::min(best, seconds);
+				rss_kb = std::max(rss_kb, rss);
+			}
+
+			string name = "script/" + script.stem().string() + (tree ? "/tree" : "/vm");
+			if (!ok)
+			{
+				std::fprintf(stderr, "bench_scripts: %s failed\n", name.c_str());
+				failed++;
+				continue;
+			}
+			bench::report(name, 1, best, rss_kb);
+		}
+	}
+
+	return failed == 0 ? 0 : 1;
+#endif
+}
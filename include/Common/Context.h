@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include "Position.h"
@@ -8,22 +9,41 @@
 namespace Basic
 {
 	// 该类用于记录当前程序运行的“上下文”，可用于错误栈定位
+	// 函数调用时只引用“上文”与符号表，不做拷贝
 	class Context
 	{
 	public:
-		Context(const string &display_name = "", const shared_ptr<Context> &parent = nullptr, const Position &parent_entry_pos = Position());
+		// 未给出symbol_table时新建一个空的符号表
+		Context(const string &display_name = "", Context *parent = nullptr, const Position &parent_entry_pos = Position(), const shared_ptr<SymbolTable> &symbol_table = nullptr);
 		Context(const Context &);
-		void set_symbol_table(const SymbolTable &);
+		void set_symbol_table(const shared_ptr<SymbolTable> &);
 
 		const string &get_displayName();
 		const Position &get_parent_entry_pos();
-		const shared_ptr<Context> &get_parent();
+		Context *get_parent();
 		SymbolTable &get_symbol_table();
+		const shared_ptr<SymbolTable> &get_shared_symbol_table();
+		// 调用层数，顶层为0
+		size_t get_depth();
+
+		// 调用层数的上限，超过时报错而不是耗尽C++栈
+		static void set_max_depth(size_t depth);
+		static size_t get_max_depth();
+
+		// 记录主线程C++栈的起点，并按栈大小的上限算出可用的栈空间
+		static void mark_stack_base();
+		// 树遍历解释器的调用在C++栈上递归，栈空间将要耗尽时返回true
+		static bool stack_exhausted();
 
 	private:
-		string display_name;		// 当前环境名称
-		Position parent_entry_pos;	// “上文”的错误定位
-		shared_ptr<Context> parent; // 指向“上文”
-		SymbolTable symbol_table;	// 当前环境中的变量集合
+		string display_name;				   // 当前环境名称
+		Position parent_entry_pos;			   // “上文”的错误定位
+		Context *parent;					   // 指向“上文”，仅在本次调用期间有效
+		shared_ptr<SymbolTable> symbol_table; // 当前环境中的变量集合
+		size_t depth;
+
+		static size_t max_depth;
+		static uintptr_t stack_base;
+		static size_t stack_budget;
 	};
-}
\ No newline at end of file
+}
@@ -20,5 +20,6 @@ namespace Basic
 		string details;
 	};
 
-	string string_with_arrows(const string &content, const Position &start, const Position &end);
+	// 源码从SourceRegistry中读取
+	string string_with_arrows(const Position &start, const Position &end);
 }
\ No newline at end of file
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <cstddef>
+
+using std::string;
+using std::string_view;
+
+namespace Basic
+{
+	// 只读映射整个文件，数据在对象销毁前有效
+	// 映射失败（如空文件、不支持映射的平台）时退回到读入内存
+	class MappedFile
+	{
+	public:
+		MappedFile() = default;
+		~MappedFile();
+
+		MappedFile(const MappedFile &) = delete;
+		MappedFile &operator=(const MappedFile &) = delete;
+
+		// 文件不存在或无法读取时返回false
+		bool open(const string &path);
+		void close();
+
+		string_view data() const;
+
+	private:
+		const char *addr = nullptr;
+		size_t length = 0;
+		string fallback; // 未能映射时保存文件内容
+	};
+}
@@ -1,23 +1,55 @@
 #pragma once
 #include <string>
+#include <string_view>
+#include <vector>
+#include <deque>
+#include <map>
+#include <cstdint>
+using std::deque;
+using std::map;
+using std::pair;
 using std::string;
+using std::string_view;
+using std::vector;
 
 namespace Basic
 {
+	// 源码登记表，每个文件的名称与内容只保存一份
+	// Position中只记录其编号，Token中的string_view也指向这里的内容
+	// 登记后的内容在程序结束前不会移动或释放
+	class SourceRegistry
+	{
+	public:
+		// 登记一段源码，同名且内容相同时复用已有编号
+		static uint32_t add(const string &filename, const string &content);
+
+		static const string &get_name(uint32_t file_id);
+		static const string &get_content(uint32_t file_id);
+
+		// 保存一段由源码派生的文本（如转义后的字符串字面量），返回指向它的视图
+		static string_view keep(string text);
+
+	private:
+		static deque<pair<string, string>> &sources();
+		static map<string, uint32_t> &latest();
+		static deque<string> &kept();
+	};
+
 	// Track line number, column number and current index
-	// also the FileName, and FileContent
+	// also the id of the source file
 	class Position
 	{
 
 	public:
-		Position(int idx = -1, int line = 0, int col = -1, const string &filename = "", const string &ftx = "");
-		Position(const Position &);
+		Position(int idx = -1, int line = 0, int col = -1, uint32_t file_id = 0);
 		void advance(char current_char = '\0');
 
+		const string &fileName() const;
+		const string &fileContent() const;
+
 		int index;
 		int row;
 		int column;
-		string fileName;
-		string fileContent;
+		uint32_t file_id;
 	};
-}
\ No newline at end of file
+}
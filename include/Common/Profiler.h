@@ -0,0 +1,66 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <ostream>
+#include "Position.h"
+
+using std::string;
+using std::vector;
+
+namespace Basic
+{
+	// 采样分析器
+	// 后台线程每隔一段时间置位pending，解释器在安全点（每条指令/每个结点）检查它并记录当前调用栈
+	// 两次采样之间经过的时间记在采样时的调用栈上，函数调用次数则逐次统计
+	class Profiler
+	{
+	public:
+		// 开始采样，interval_us为采样间隔(微秒)
+		static void start(int interval_us = 1000);
+		static void stop();
+
+		static bool active()
+		{
+			return is_active;
+		}
+
+		// 安全点：pos为正在执行的位置
+		static void poll(const Position &pos)
+		{
+			if (pending.load(std::memory_order_relaxed))
+				sample(pos);
+		}
+
+		// 函数调用期间在调用栈上压入一帧，未启用时什么也不做
+		class Scope
+		{
+		public:
+			// name需在本对象销毁前有效；call_pos为调用处，记作调用者的当前行
+			Scope(const string &name, const Position &call_pos);
+			~Scope();
+
+		private:
+			bool pushed;
+		};
+
+		// 按自身耗时排序的函数与行的报告
+		static void report(std::ostream &os);
+		// 折叠调用栈（flamegraph.pl等工具的输入），每行为"a;b;c 微秒数"
+		static bool write_collapsed(const string &path);
+
+	private:
+		struct Frame
+		{
+			const string *name;
+			Position pos; // 该帧当前执行的位置
+		};
+
+		static void sample(const Position &pos);
+
+		static bool is_active;
+		static std::atomic<bool> pending;
+		static vector<Frame> frames;
+	};
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "Position.h"
+
+using std::string;
+using std::vector;
+
+namespace Basic
+{
+	// 以Chrome trace-event格式记录各阶段与函数调用的耗时
+	// 生成的JSON可在Perfetto或chrome://tracing中查看
+	class Tracer
+	{
+	public:
+		static void start();
+		static bool active()
+		{
+			return is_active;
+		}
+		// 写出已记录的事件并停止记录
+		static bool write(const string &path);
+
+		// 记录一段区间（complete event），对象销毁时结束
+		// 未启用时什么也不做
+		class Scope
+		{
+		public:
+			Scope(const char *category, const string &name);
+			// 函数调用，pos为调用处
+			Scope(const char *category, const string &name, const Position &pos);
+			~Scope();
+
+			// 附加说明，显示在事件的args中
+			void detail(const string &text);
+
+		private:
+			size_t index; // 事件在events中的下标
+			bool recording;
+		};
+
+	private:
+		struct Event
+		{
+			const char *category;
+			string name;
+			string detail;
+			double start_us;
+			double duration_us;
+		};
+
+		static double now_us();
+
+		static bool is_active;
+		static vector<Event> events;
+		static size_t dropped;
+	};
+}
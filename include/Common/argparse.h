@@ -429,7 +429,9 @@ namespace argparse
          */
         Entry &flag(const std::string &key, const std::string &help)
         {
-            return kwarg(key, help, "true").set_default<bool>(false);
+            Entry &entry = kwarg(key, help, "true").set_default<bool>(false);
+            entry.type = Entry::FLAG; // flags never consume the next parameter
+            return entry;
         }
 
         virtual void welcome() {} // Allow to overwrite the `welcome` function to add a welcome-message to the help output
@@ -492,8 +494,8 @@ namespace argparse
                     {
                         entry->_convert(equal_value.value());
                     }
-                    else if (entry->implicit_value_.has_value())
-                    {
+                    else if (entry->implicit_value_.has_value() && (entry->type == Entry::FLAG || is_short || !is_value(i + 1)))
+                    { // a kwarg with an implicit value still takes a separated value (--key value) when one follows
                         entry->_convert(*entry->implicit_value_);
                     }
                     else if (!is_short)
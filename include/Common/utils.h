@@ -9,6 +9,7 @@
 #include <optional>
 #include <algorithm>
 #include <tuple>
+#include <cstdint>
 #include "Error.h"
 #include "crossline.h"
 #include "Interpreter/Data.h"
@@ -36,7 +37,21 @@ namespace Basic
 
 	vector<string> split(const string &str, const string &regex);
 
-	tuple<DataPtr, shared_ptr<Error>> run(const string &filename, const string &text);
+	// FOR循环将要执行的次数，最多为limit（步长为0时不会结束）
+	// 用于预留结果列表的容量，循环可能提前BREAK，故默认上限不宜过大
+	size_t loop_count(int64_t start, int64_t end, int64_t step, size_t limit = 1 << 16);
+
+	// 将FOR循环的起点、终点或步长取整为64位整数，超出范围或为NaN时返回false
+	bool loop_bound(double value, int64_t &result);
+
+	// FOR循环的计数器前进一步。会溢出时不修改i并返回false，此时已越过任何终点，循环应当结束
+	bool loop_advance(int64_t &i, int64_t step);
+
+	// keep_value为真时（交互模式）保留程序的值，否则不收集语句层面循环等的结果
+	tuple<DataPtr, shared_ptr<Error>> run(const string &filename, const string &text, bool keep_value = false);
+
+	// 运行脚本文件，重复运行同一文件时复用已编译的结果；无法读取文件时返回空
+	std::optional<tuple<DataPtr, shared_ptr<Error>>> run_file(const string &file_path);
 
 	std::optional<string> readfile(const string &file_path);
 
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <cstdint>
+#include "Common/Position.h"
+#include "Lexer/Token.h"
+#include "Interpreter/Data.h"
+
+using std::pair;
+using std::shared_ptr;
+using std::string;
+using std::vector;
+
+namespace Basic
+{
+	// 字节码指令集
+	// 每条指令最多带两个操作数a、b，含义见注释
+	enum class OpCode : uint8_t
+	{
+		NUMBER,		   // 压入数值表中第a个数值
+		CONSTANT,	   // 压入常量池中第a个常量，与常量池共享，装箱时才拷贝
+		NONE,		   // 压入空值(undefined)
+		POP,		   // 弹出栈顶
+		GET_VAR,	   // 按名称a取变量的拷贝（List/Dict除外）
+		GET_REF,	   // 按名称a取变量的引用
+		GET_LOCAL,	   // 取外层第b个函数的第a个槽位的拷贝，槽位为空时按名称查找
+		GET_LOCAL_REF, // 同上，取引用
+		DEFINE,		   // VAR a = 栈顶，值保留在栈上
+		DEFINE_LOCAL,  // 同上，写入第a个槽位
+		SET_VAR,	   // 将栈顶直接写入变量a（不拷贝），值保留在栈上
+		SET_LOCAL,	   // 同上，写入第a个槽位
+		MUTATE,		   // 以栈顶的值覆盖次栈顶的变量
+		DELETE,		   // DEL a
+		DELETE_LOCAL,  // DEL 第a个槽位
+		BUILD_LIST,	   // 以栈顶a个元素构造List，b为1时跳过空值
+		BUILD_DICT,	   // 以栈顶元素和第a组键名构造Dict
+		ADD,		   // +
+		SUB,		   // -
+		MUL,		   // *
+		DIV,		   // /
+		POW,		   // ^
+		EE,			   // ==
+		NE,			   // !=
+		LT,			   // <
+		GT,			   // >
+		LTE,		   // <=
+		GTE,		   // >=
+		AND,		   // AND
+		OR,			   // OR
+		NEGATE,		   // 一元负号
+		NOT,		   // NOT
+		INDEX,		   // 次栈顶[栈顶]
+		ATTR,		   // 栈顶.第a个属性
+		JUMP,		   // 跳转到a
+		JUMP_IF_FALSE, // 弹出栈顶，为假则跳转到a
+		LIST_NEW,	   // 压入一个空List，用于收集循环结果
+		ACCUMULATE,	   // 弹出栈顶，非空则追加到栈上第a个位置的List
+		LOOP_RESULT,   // 收集结果为空时替换为空值
+		FOR_PREP,	   // 弹出起点、终点、步长(b为1时)，开始FOR循环；a为1时为下方的List预留容量
+		FOR_LOCAL,	   // 循环结束则跳转到a，否则把计数器写入第b个槽位并步进
+		FOR_VAR,	   // 同上，写入名为第b个名称的变量
+		FOR_END,	   // 结束FOR循环
+		MAKE_FUNCTION, // 由第a个函数原型构造函数
+		CALL,		   // 以栈顶a个参数调用函数
+		TAIL_CALL,	   // 同CALL，但调用的值直接作为返回值；用户函数交由Function::execute接着执行
+		RETURN,		   // 弹出栈顶，作为函数返回值
+		HALT		   // 弹出栈顶，作为整段代码的值
+	};
+
+	struct Instruction
+	{
+		OpCode op;
+		uint32_t a;
+		uint32_t b;
+	};
+
+	class Chunk;
+
+	// 函数原型，编译期生成，运行时据此构造Function
+	struct FunctionProto
+	{
+		string name;
+		vector<string> arg_names;
+		bool auto_return;
+		shared_ptr<Chunk> chunk;
+	};
+
+	// 一段编译好的字节码，及其常量池、名称表与源码位置
+	class Chunk
+	{
+	public:
+		Chunk(const string &name = "<program>");
+
+		const Position &get_pos_start(size_t ip);
+		const Position &get_pos_end(size_t ip);
+
+		string disassemble();
+
+	public:
+		string name;
+		vector<Instruction> code;
+		vector<uint32_t> span_of;				 // 每条指令对应的源码区间下标
+		vector<pair<Position, Position>> spans; // 源码区间
+		vector<double> numbers;	   // 数值常量，VM中不需要装箱
+		vector<DataPtr> constants; // 其余常量
+		vector<string> names;
+		vector<vector<string>> key_sets; // Dict的键名
+		vector<Token> attributes;		 // '.'之后的属性名
+		vector<FunctionProto> functions;
+		vector<string> local_names; // 函数体中每个槽位对应的变量名
+		vector<uint32_t> arg_slots; // 每个参数所在的槽位
+		int max_stack;
+	};
+
+	const char *opcode_name(OpCode op);
+}
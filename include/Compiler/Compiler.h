@@ -0,0 +1,85 @@
+#pragma once
+
+#include <map>
+#include "Parser/Node.h"
+#include "Chunk.h"
+#include "Resolver.h"
+
+using std::map;
+
+namespace Basic
+{
+	// 将AST编译为字节码，供VM执行
+	// 语义与Interpreter（树遍历解释器）保持一致
+	class Compiler
+	{
+	public:
+		// scopes为外层各函数的槽位，由内向外的下标依次减小
+		Compiler(const vector<map<string, uint32_t>> &scopes = {});
+
+		// 编译语法树，出错时抛出InvalidSyntaxError
+		shared_ptr<Chunk> compile(ASTNode *root, const string &name = "<program>");
+
+	private:
+		void compile_node(ASTNode *root, bool byRef = false);
+
+		void compile_NumberNode(NumberNode *root);
+		void compile_StringNode(StringNode *root);
+		void compile_ListNode(ListNode *root);
+		void compile_DictNode(DictNode *root);
+
+		void compile_BinOpNode(BinOpNode *root);
+		void compile_UnaryOpNode(UnaryOpNode *root);
+
+		void compile_VarAccessNode(VarAccessNode *root, bool byRef);
+		void compile_VarDeleteNode(VarDeleteNode *root);
+		void compile_MutateNode(MutateNode *root);
+		void compile_DefineNode(DefineNode *root);
+		void compile_VarAssignNode(VarAssignNode *root);
+		void compile_IndexNode(IndexNode *root);
+		void compile_AttrNode(AttrNode *root);
+
+		void compile_IfNode(IfNode *root);
+		void compile_ForNode(ForNode *root);
+		void compile_WhileNode(WhileNode *root);
+
+		void compile_FuncDefNode(FuncDefNode *root);
+		void compile_CallNode(CallNode *root);
+		void compile_ReturnNode(ReturnNode *root);
+		void compile_BreakNode(BreakNode *root);
+		void compile_ContinueNode(ContinueNode *root);
+
+		// 生成一条指令，并维护编译期的栈深度
+		size_t emit(OpCode op, uint32_t a = 0, uint32_t b = 0);
+		// 回填跳转目标
+		void patch_jump(size_t at);
+		// 弹出栈顶元素，直到栈深度为depth
+		void pop_to(int depth);
+		// 之后生成的指令均对应于该节点的源码区间
+		void set_span(ASTNode *node);
+
+		// 相同的字面量在常量池中只保存一份
+		uint32_t make_number(double value);
+		uint32_t make_string(const string &text);
+		uint32_t make_name(const string &name);
+		// 在外层函数中查找变量，找到时给出槽位与相隔的层数
+		bool resolve(const string &name, uint32_t &slot, uint32_t &depth);
+
+		// 记录循环的信息，用于BREAK与CONTINUE
+		struct LoopInfo
+		{
+			int depth;				  // 循环体开始时的栈深度
+			size_t continue_target;	  // CONTINUE跳转的位置
+			vector<size_t> break_jumps; // 待回填的BREAK跳转
+		};
+
+		shared_ptr<Chunk> chunk;
+		vector<map<string, uint32_t>> scopes;
+		vector<LoopInfo> loops;
+		map<string, uint32_t> name_index;
+		map<uint64_t, uint32_t> number_index;
+		map<string, uint32_t> string_index;
+		const ASTNode *span_node;
+		int depth;
+	};
+}
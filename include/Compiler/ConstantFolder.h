@@ -0,0 +1,35 @@
+#pragma once
+
+#include <deque>
+#include "Parser/Node.h"
+#include "Interpreter/Data.h"
+
+using std::deque;
+
+namespace Basic
+{
+	// 常量折叠：运行前计算只由字面量组成的表达式，如 2 * 3.14、-1、"a" + "b"
+	// 折叠结果与运行时的运算完全一致；会出错的运算（如除以0）保持原样，仍在运行时报错
+	// 开启常量池时（树遍历模式），还为每个字面量预先生成值，求值时不再逐次分配
+	class ConstantFolder
+	{
+	public:
+		ConstantFolder(const shared_ptr<AstArena> &arena, bool use_pool);
+
+		// 返回折叠后的根结点，新结点分配在同一内存池中
+		ASTNode *fold(ASTNode *root);
+
+	private:
+		void visit(ASTNode *&root);
+		ASTNode *fold_BinOpNode(BinOpNode *root);
+		ASTNode *fold_UnaryOpNode(UnaryOpNode *root);
+
+		ASTNode *make_number(double value, const Position &start, const Position &end);
+		ASTNode *make_string(string value, const Position &start, const Position &end);
+		// 为字面量结点生成常量池中的值
+		void materialize(ASTNode *root);
+
+		shared_ptr<AstArena> arena;
+		shared_ptr<deque<DataPtr>> pool; // deque扩容时不移动元素，结点可以保存其地址
+	};
+}
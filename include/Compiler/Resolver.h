@@ -0,0 +1,28 @@
+#pragma once
+
+#include <map>
+#include "Parser/Node.h"
+
+using std::map;
+
+namespace Basic
+{
+	// 编译前对函数体做一次遍历，为其中的局部变量分配槽位
+	// 局部变量包括：参数、VAR定义的变量、FOR循环变量以及具名的内部函数
+	// 内部函数的函数体不在此处遍历，它们有自己的槽位
+	class Resolver
+	{
+	public:
+		void resolve(FuncDefNode *root);
+
+		const map<string, uint32_t> &get_slots();
+		const vector<string> &get_names();
+
+	private:
+		void visit(ASTNode *root);
+		void declare(string_view name);
+
+		map<string, uint32_t> slots; // 变量名 -> 槽位
+		vector<string> names;		 // 槽位 -> 变量名
+	};
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "Parser/Node.h"
+
+namespace Basic
+{
+	// 找出值不会被使用的循环与语句块，标记为return_null，运行时不再收集其结果
+	// 如：语句层面的单行循环、多行循环体、不自动返回的函数体
+	// 参与运算、赋值、传参的值都视为会被使用
+	class ResultElider
+	{
+	public:
+		// used为整个程序的值是否会被使用（交互模式需要输出它）
+		void elide(ASTNode *root, bool used);
+
+	private:
+		void visit(ASTNode *root, bool used);
+	};
+}
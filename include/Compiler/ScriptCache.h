@@ -0,0 +1,76 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <memory>
+#include <unordered_map>
+#include <cstdint>
+#include "Parser/Node.h"
+#include "Chunk.h"
+
+using std::shared_ptr;
+using std::string;
+using std::string_view;
+using std::unordered_map;
+
+namespace Basic
+{
+	// 前端（词法、语法分析及编译）的结果
+	// 树遍历模式使用语法树，字节码模式只保留Chunk
+	struct Program
+	{
+		shared_ptr<AstArena> arena;
+		ASTNode *root = nullptr; // 为空且chunk为空时表示源码中只有注释
+		shared_ptr<Chunk> chunk;
+	};
+
+	// 已加载脚本的缓存，RUN与-f重复加载同一文件时跳过前端
+	// 以路径为键：修改时间与大小不变时直接复用；否则比较内容的哈希
+	// 设置了磁盘目录时，字节码还会写入磁盘，供之后的进程使用
+	class ScriptCache
+	{
+	public:
+		// 文件的修改时间与大小
+		struct Stamp
+		{
+			int64_t mtime = 0;
+			uint64_t size = 0;
+
+			bool operator==(const Stamp &other) const
+			{
+				return mtime == other.mtime && size == other.size;
+			}
+		};
+
+		// 读取文件状态，文件不存在时返回false
+		static bool stat(const string &path, Stamp &stamp);
+
+		// 文件状态与缓存一致时取出缓存的程序
+		static bool find(const string &path, const Stamp &stamp, Program &program);
+		// 文件内容与缓存一致（如仅被touch）时更新其状态并取出缓存的程序
+		static bool find(const string &path, const Stamp &stamp, uint64_t hash, Program &program);
+		static void store(const string &path, const Stamp &stamp, uint64_t hash, const Program &program);
+
+		// 磁盘缓存，dir为空时不启用
+		static void set_disk_dir(const string &dir);
+		// 读取与源码哈希一致的字节码，没有或已过期时返回nullptr
+		static shared_ptr<Chunk> load_disk(const string &path, uint64_t hash);
+		static void save_disk(const string &path, uint64_t hash, const string &source, const Chunk &chunk);
+
+		// 源码内容的哈希(FNV-1a)
+		static uint64_t hash(string_view text);
+
+	private:
+		struct Entry
+		{
+			Stamp stamp;
+			uint64_t hash;
+			Program program;
+		};
+
+		static string disk_path(const string &path);
+
+		static unordered_map<string, Entry> &entries();
+		static string &disk_dir();
+	};
+}
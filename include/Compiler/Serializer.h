@@ -0,0 +1,33 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <memory>
+#include <cstdint>
+#include "Chunk.h"
+
+using std::shared_ptr;
+using std::string;
+using std::string_view;
+
+namespace Basic
+{
+	// 字节码的二进制格式，用于把编译结果保存到磁盘
+	// 文件中同时保存源码，加载时重新登记，使报错信息仍能指向源码
+	// 数值按本机字节序存放，只在同一平台上使用
+	// 文件头：魔数、版本号、其后全部内容的校验和
+	class Serializer
+	{
+	public:
+		static const uint32_t VERSION = 4;
+
+		// 常量池中含有字符串以外的常量时无法保存，返回false
+		static bool save(const Chunk &chunk, const string &source_name, const string &source, uint64_t source_hash, string &out);
+
+		// 格式或版本不符、校验和不一致、数据不完整或操作数越界时返回nullptr
+		static shared_ptr<Chunk> load(string_view data, uint64_t &source_hash);
+
+		// FNV-1a哈希，用作校验和
+		static uint64_t checksum(string_view data);
+	};
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "Parser/Node.h"
+
+namespace Basic
+{
+	// 标记函数体中处于尾部的调用：RETURN f(...)，以及自动返回的函数体本身或其单行IF分支
+	// 这些调用的值直接作为函数的返回值，执行时不再嵌套一层，而是由当前调用接着执行
+	class TailCallMarker
+	{
+	public:
+		void mark(ASTNode *root);
+
+	private:
+		// in_function为是否在函数体内，顶层的RETURN不做标记
+		void visit(ASTNode *root, bool in_function);
+		// 标记node及其单行IF分支中的调用
+		void tail(ASTNode *node);
+	};
+}
@@ -8,6 +8,8 @@
 #include "Parser/Node.h"
 #include "RuntimeResult.h"
 #include "RunTimeError.h"
+#include "DictTable.h"
+#include "Stats.h"
 
 using std::function;
 using std::make_shared;
@@ -21,11 +23,43 @@ namespace Basic
 {
 	using DataPtr = shared_ptr<unique_ptr<Data>>;
 
+	class Chunk;
+	class Environment;
+	class MemoCache;
+	class Number;
+	class String;
+	class List;
+	class Dict;
+	class Function;
+	class BuiltInFunction;
+	class MemoFunction;
+
+	template <class T>
+	constexpr DataKind data_kind()
+	{
+		if constexpr (std::is_same<T, Number>::value)
+			return DataKind::NUMBER;
+		else if constexpr (std::is_same<T, String>::value)
+			return DataKind::STRING;
+		else if constexpr (std::is_same<T, List>::value)
+			return DataKind::LIST;
+		else if constexpr (std::is_same<T, Dict>::value)
+			return DataKind::DICT;
+		else if constexpr (std::is_same<T, Function>::value || std::is_same<T, MemoFunction>::value)
+			return DataKind::FUNCTION;
+		else if constexpr (std::is_same<T, BuiltInFunction>::value)
+			return DataKind::BUILTIN;
+		else
+			return DataKind::DATA;
+	}
+
+	// 所有Data都应经由此处创建，以便按类型统计分配次数
 	template <class T, typename... Args>
-	DataPtr make_Dataptr(const Args &...args)
+	DataPtr make_Dataptr(Args &&...args)
 	{
 		static_assert(std::is_base_of<Data, T>::value, "T must inherit from Data");
-		return make_shared<unique_ptr<Data>>(make_unique<T>(args...));
+		Stats::allocated(data_kind<T>());
+		return make_shared<unique_ptr<Data>>(make_unique<T>(std::forward<Args>(args)...));
 	}
 
 	// 注意，传入的ptr不可以是右值（临时变量），否则T*和ptr会在函数结束后一同销毁
@@ -38,16 +72,30 @@ namespace Basic
 	class Data
 	{
 	public:
+		Data()
+		{
+			Stats::value_created();
+		}
+
+		Data(const Data &other) : pos_start(other.pos_start), pos_end(other.pos_end), context(other.context)
+		{
+			Stats::value_created();
+		}
+
+		Data &operator=(const Data &) = default;
+
 		void set_pos(const Position &start, const Position &end);
 		void set_context(Context *);
 
 		virtual ~Data()
 		{
 			context = nullptr;
+			Stats::value_destroyed();
 		}
 
 		virtual DataPtr clone()
 		{
+			Stats::cloned();
 			return make_Dataptr<Data>(*this);
 		}
 
@@ -171,6 +219,10 @@ namespace Basic
 		Number(const Number &);
 		~Number() {}
 		double get_value(bool wantInt = false);
+		void set_value(double value);
+		// 令cell存放数值value：cell未被共享且已是Number时原地修改，否则换成新的Number
+		// 用于FOR循环变量，避免每次循环都分配
+		static void assign(DataPtr &cell, double value);
 
 		DataPtr clone() override;
 		DataPtr added_to(const DataPtr &other) override;
@@ -209,10 +261,7 @@ namespace Basic
 	public:
 		String(string value);
 		String(const String &);
-		~String()
-		{
-			value.clear();
-		}
+		~String() {}
 
 		DataPtr clone() override;
 		DataPtr added_to(const DataPtr &) override;
@@ -225,22 +274,21 @@ namespace Basic
 
 		bool is_true() override;
 		string repr() override;
-		string str(); // Print时不希望带有引号
-		string getValue();
+		const string &str(); // Print时不希望带有引号
+		const string &getValue();
 
 	private:
-		string value;
+		// 字符串不可变，拷贝时共享同一块存储
+		shared_ptr<const string> value;
 	};
 
 	class List : public Data
 	{
 	public:
 		List(const vector<DataPtr> &elems);
+		List(vector<DataPtr> &&elems);
 		List(const List &);
-		~List()
-		{
-			elements.clear();
-		}
+		~List() {}
 
 		DataPtr clone() override;
 
@@ -261,21 +309,35 @@ namespace Basic
 
 		string repr() override;
 
+		// 只读访问
+		size_t size() const;
+		vector<DataPtr>::const_iterator begin() const;
+		vector<DataPtr>::const_iterator end() const;
+
+		// 可写访问，存储被共享时会先复制一份
+		// 返回的引用在本List被拷贝后失效
 		vector<DataPtr> &get_elements();
 
 	private:
-		vector<DataPtr> elements;
+		// 在末尾追加，若本List恰好位于共享存储的末尾则无需复制
+		void push(const DataPtr &elem);
+
+		// 多个List可以共享同一块存储，写时复制
+		// 每个List只能看到前length个元素，之后的是其他共享者追加的
+		shared_ptr<vector<DataPtr>> elements;
+
+		// 经get_elements()写入后为npos，表示独占存储且长度以存储为准
+		// 被拷贝时会固定为当前长度，故声明为mutable
+		mutable size_t length;
 	};
 
 	class Dict : public Data
 	{
 	public:
-		Dict(const map<string, DataPtr> &elem);
+		Dict(const DictTable &elem);
+		Dict(DictTable &&elem);
 		Dict(const Dict &other);
-		~Dict()
-		{
-			elements.clear();
-		}
+		~Dict() {}
 
 		// get elem of given name(String)
 		DataPtr index_by(const DataPtr &) override;
@@ -285,8 +347,15 @@ namespace Basic
 		DataPtr clone() override;
 		string repr() override;
 
+		// 只读访问
+		const DictTable &get_table() const;
+
 	private:
-		map<string, DataPtr> elements;
+		// 写入前若存储被共享则先复制一份
+		DictTable &mutable_elements();
+
+		// 拷贝时共享，写时复制
+		shared_ptr<DictTable> elements;
 	};
 
 	// 函数类的基类，封装了公有行为
@@ -313,10 +382,12 @@ namespace Basic
 	protected:
 		string func_name;
 
-	private:
 		// 检查参数个数是否匹配
 		RuntimeResult check_args(const vector<string> &arg_names, const vector<DataPtr> &args);
+		// 同上，错误位于start到end，上下文为context
+		RuntimeResult check_args(const vector<string> &arg_names, const vector<DataPtr> &args, const Position &start, const Position &end, Context &context);
 
+	private:
 		// 将<参数-值>对，加入到Symbol_Table中
 		void populate_args(const vector<string> &arg_names, vector<DataPtr> &args, Context &exec_ctx);
 	};
@@ -324,23 +395,57 @@ namespace Basic
 	class Function : public BaseFunction
 	{
 	public:
-		Function(const string &func_name, const shared_ptr<ASTNode> &body_node, const vector<string> &arg_names, bool auto_return = true);
+		Function(const string &func_name, ASTNode *body_node, const shared_ptr<AstArena> &arena, const vector<string> &arg_names, bool auto_return = true, const shared_ptr<Chunk> &chunk = nullptr, const shared_ptr<Environment> &closure = nullptr);
 		Function(const Function &);
 		~Function()
 		{
-			body_node.reset();
+			arena.reset();
+			chunk.reset();
+			closure.reset();
 			arg_names.clear();
 		}
 		DataPtr clone() override;
 
 		RuntimeResult execute(vector<DataPtr> &args) override;
 
+		// 以下供虚拟机在自己的帧栈上调用字节码函数
+		bool is_compiled() const { return chunk != nullptr; }
+		bool is_auto_return() const { return auto_return; }
+		const string &get_func_name() const { return func_name; }
+		const shared_ptr<Chunk> &get_chunk() const { return chunk; }
+		// 检查参数，建立本次调用的局部环境并将参数放入槽位
+		// 参数个数不符时，错误位于调用处call_start到call_end，上下文为func_context的调用者
+		RuntimeResult bind(vector<DataPtr> &args, Context &func_context, shared_ptr<Environment> &env, const Position &call_start, const Position &call_end);
+
 	private:
-		shared_ptr<ASTNode> body_node;
+		ASTNode *body_node;
+		shared_ptr<AstArena> arena;		   // 函数体所在的语法树内存池，使其不随Basic::run结束而释放
+		shared_ptr<Chunk> chunk;		   // 编译后的函数体，为空时使用树遍历解释器
+		shared_ptr<Environment> closure; // 定义该函数时所在的环境
 		vector<string> arg_names;
 		bool auto_return;
 	};
 
+	// MEMO(func, size)的结果：以参数为键缓存func的返回值
+	class MemoFunction : public BaseFunction
+	{
+	public:
+		MemoFunction(const DataPtr &func, size_t capacity);
+		MemoFunction(const MemoFunction &);
+		~MemoFunction() {}
+
+		DataPtr clone() override;
+
+		RuntimeResult execute(vector<DataPtr> &args) override;
+
+		const DataPtr &get_func();
+		const shared_ptr<MemoCache> &get_cache();
+
+	private:
+		DataPtr func;				   // 被缓存的Function
+		shared_ptr<MemoCache> cache; // 拷贝时共享
+	};
+
 	class BuiltInFunction : public BaseFunction
 	{
 	public:
@@ -356,64 +461,82 @@ namespace Basic
 		// 内置函数
 
 		// 运行外部文件
-		RuntimeResult execute_run(Context &exec_ctx);
+		RuntimeResult execute_run(Context &exec_ctx, vector<DataPtr> &args);
 
 		// 输出value
-		RuntimeResult execute_print(Context &exec_ctx);
+		RuntimeResult execute_print(Context &exec_ctx, vector<DataPtr> &args);
 
 		// 将传入的列表中的元素以空格拼接，输出
-		RuntimeResult execute_prints(Context &exec_ctx);
+		RuntimeResult execute_prints(Context &exec_ctx, vector<DataPtr> &args);
 
 		// 返回value
-		RuntimeResult execute_print_ret(Context &exec_ctx);
+		RuntimeResult execute_print_ret(Context &exec_ctx, vector<DataPtr> &args);
 
 		// 输入（以字符串存储）
-		RuntimeResult execute_input(Context &exec_ctx);
+		RuntimeResult execute_input(Context &exec_ctx, vector<DataPtr> &args);
 
 		// 输入（以数字存储）
-		RuntimeResult execute_input_num(Context &exec_ctx);
+		RuntimeResult execute_input_num(Context &exec_ctx, vector<DataPtr> &args);
 
 		// 清屏
-		RuntimeResult execute_clear(Context &exec_ctx);
+		RuntimeResult execute_clear(Context &exec_ctx, vector<DataPtr> &args);
 
 		// 判断变量是否为数字
-		RuntimeResult execute_is_number(Context &exec_ctx);
+		RuntimeResult execute_is_number(Context &exec_ctx, vector<DataPtr> &args);
 
 		// 判断变量是否为字符串
-		RuntimeResult execute_is_string(Context &exec_ctx);
+		RuntimeResult execute_is_string(Context &exec_ctx, vector<DataPtr> &args);
 
 		// 判断变量是否为列表
-		RuntimeResult execute_is_list(Context &exec_ctx);
+		RuntimeResult execute_is_list(Context &exec_ctx, vector<DataPtr> &args);
 
 		// 判断变量是否为函数
-		RuntimeResult execute_is_function(Context &exec_ctx);
+		RuntimeResult execute_is_function(Context &exec_ctx, vector<DataPtr> &args);
 
 		// 返回列表/字符串长度
-		RuntimeResult execute_len(Context &exec_ctx);
+		RuntimeResult execute_len(Context &exec_ctx, vector<DataPtr> &args);
 
 		// 列表末尾追加元素(mutable)
-		RuntimeResult execute_append(Context &exec_ctx);
+		RuntimeResult execute_append(Context &exec_ctx, vector<DataPtr> &args);
 
 		// 弹出指定位置的元素
-		RuntimeResult execute_pop(Context &exec_ctx);
+		RuntimeResult execute_pop(Context &exec_ctx, vector<DataPtr> &args);
 
 		// 弹出列表首部元素(mutable)
-		RuntimeResult execute_pop_front(Context &exec_ctx);
+		RuntimeResult execute_pop_front(Context &exec_ctx, vector<DataPtr> &args);
 
 		// 弹出列表尾部元素(mutable)
-		RuntimeResult execute_pop_back(Context &exec_ctx);
+		RuntimeResult execute_pop_back(Context &exec_ctx, vector<DataPtr> &args);
 
 		// 合并两个列表(mutable)
-		RuntimeResult execute_extend(Context &exec_ctx);
+		RuntimeResult execute_extend(Context &exec_ctx, vector<DataPtr> &args);
 
 		// 交换两个变量
-		RuntimeResult execute_swap(Context &exec_ctx);
+		RuntimeResult execute_swap(Context &exec_ctx, vector<DataPtr> &args);
+
+		// 运行时计数器，以Dict返回
+		RuntimeResult execute_stats(Context &exec_ctx, vector<DataPtr> &args);
+
+		// 为函数加上容量为size的结果缓存
+		RuntimeResult execute_memo(Context &exec_ctx, vector<DataPtr> &args);
+
+		// MEMO函数的缓存命中情况，以Dict返回
+		RuntimeResult execute_memo_stats(Context &exec_ctx, vector<DataPtr> &args);
 
 	private:
-		// 名称-函数对应
-		static const map<string, function<RuntimeResult(BuiltInFunction *, Context &)>> func_name_map;
+		// 内置函数的实现，参数按位置传入
+		using Method = RuntimeResult (BuiltInFunction::*)(Context &exec_ctx, vector<DataPtr> &args);
+
+		struct Spec
+		{
+			Method method;
+			vector<string> arg_names; // 形参表，其长度即参数个数
+		};
+
+		// 名称-实现与形参表对应
+		static const map<string, Spec> specs;
 
-		// 名称-形参表对应
-		static const map<string, vector<string>> func_args_map;
+		// 构造时按名称找到，调用时不再查表；名称未定义时为空
+		const Spec *spec;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+using std::shared_ptr;
+using std::string;
+using std::string_view;
+using std::unique_ptr;
+using std::vector;
+
+namespace Basic
+{
+	class Data;
+
+	// Dict的存储：开放寻址的哈希表
+	// 表项按插入顺序紧密存放，槽位数组中只保存表项下标与哈希值的高位
+	class DictTable
+	{
+	public:
+		struct Entry
+		{
+			string key;
+			uint64_t hash; // 预先计算，扩容时无需重新哈希
+			shared_ptr<unique_ptr<Data>> value;
+		};
+
+		// 预留至少n个表项的空间
+		void reserve(size_t n);
+
+		// 不存在时返回nullptr
+		const shared_ptr<unique_ptr<Data>> *find(string_view key) const;
+		// 不存在时插入一个空值，返回其引用
+		shared_ptr<unique_ptr<Data>> &operator[](string_view key);
+
+		size_t size() const;
+		vector<Entry>::const_iterator begin() const;
+		vector<Entry>::const_iterator end() const;
+
+		static uint64_t hash(string_view key);
+
+	private:
+		struct Slot
+		{
+			uint32_t entry; // 表项下标+1，为0表示空槽
+			uint32_t tag;	// 哈希值的高32位，匹配时才比较字符串
+		};
+
+		// 返回key所在的槽位，或应插入的空槽位
+		size_t probe(string_view key, uint64_t hash) const;
+		void rehash(size_t slot_count);
+
+		vector<Entry> entries;
+		vector<Slot> slots; // 大小为2的幂
+	};
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <list>
+#include <unordered_map>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+using std::list;
+using std::shared_ptr;
+using std::string;
+using std::string_view;
+using std::unique_ptr;
+using std::unordered_map;
+using std::vector;
+
+namespace Basic
+{
+	class Data;
+
+	// MEMO()的结果缓存：以参数的结构为键，超过容量时淘汰最久未使用的条目
+	class MemoCache
+	{
+	public:
+		MemoCache(size_t capacity);
+
+		// 将参数按结构编码为键，结构相同的参数得到相同的键
+		// 参数中含有函数等无法比较的值时返回false，此次调用不做缓存
+		static bool make_key(const vector<shared_ptr<unique_ptr<Data>>> &args, string &key);
+
+		// 未命中时返回nullptr，命中的条目成为最近使用的
+		shared_ptr<unique_ptr<Data>> get(const string &key);
+		void put(const string &key, const shared_ptr<unique_ptr<Data>> &value);
+
+		size_t size() const;
+		size_t get_capacity() const;
+		uint64_t get_hits() const;
+		uint64_t get_misses() const;
+
+	private:
+		struct Entry
+		{
+			string key;
+			shared_ptr<unique_ptr<Data>> value;
+		};
+
+		static bool append_key(Data *value, string &key);
+
+		size_t capacity;
+		uint64_t hits = 0;
+		uint64_t misses = 0;
+
+		list<Entry> entries;								 // 最近使用的在前
+		unordered_map<string_view, list<Entry>::iterator> index; // 键指向entries中的字符串，其地址不会改变
+	};
+}
@@ -1,7 +1,11 @@
 #pragma once
+#include <vector>
 #include "Common/Error.h"
 #include "Common/Context.h"
 
+using std::pair;
+using std::vector;
+
 namespace Basic
 {
 
@@ -15,6 +19,7 @@ namespace Basic
 		string generate_traceback();
 
 	private:
-		Context context;
+		// 构造时记录调用栈，此后“上文”可能已经销毁
+		vector<pair<string, Position>> traceback;
 	};
-}
\ No newline at end of file
+}
@@ -1,15 +1,24 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 #include "Common/Error.h"
 
 using std::shared_ptr;
 using std::unique_ptr;
+using std::vector;
 
 namespace Basic
 {
 	class Data;
 
+	// 尾调用：由正在执行的Function::execute接着调用callee，而不是嵌套调用
+	struct TailCall
+	{
+		shared_ptr<unique_ptr<Data>> callee;
+		vector<shared_ptr<unique_ptr<Data>>> args;
+	};
+
 	// 类似于ParseResult，该类将保管解释器的内容，并提供异常处理
 	class RuntimeResult
 	{
@@ -33,6 +42,9 @@ namespace Basic
 		RuntimeResult success_return(const shared_ptr<unique_ptr<Data>> &return_value);
 		RuntimeResult success_return(shared_ptr<unique_ptr<Data>> &&return_value);
 
+		// succuess for tail call
+		RuntimeResult success_tail_call(const shared_ptr<unique_ptr<Data>> &callee, vector<shared_ptr<unique_ptr<Data>>> &&args);
+
 		// succuess for loop_continue
 		RuntimeResult success_continue();
 		// succuess for loop_break
@@ -40,12 +52,13 @@ namespace Basic
 
 		bool hasError();
 
-		// 当出现Error、Return、Continue或Break时，提前终止
+		// 当出现Error、Return、尾调用、Continue或Break时，提前终止
 		bool should_return();
 
 		const shared_ptr<unique_ptr<Data>> &getValuePtr();
 		const shared_ptr<Error> &getError();
 		const shared_ptr<unique_ptr<Data>> &get_func_return_value();
+		const shared_ptr<TailCall> &get_tail_call();
 		bool should_continue();
 		bool should_break();
 
@@ -54,6 +67,9 @@ namespace Basic
 		// 若函数被Call了，那么将该值赋给value
 		shared_ptr<unique_ptr<Data>> func_return_value;
 
+		// 函数以尾调用结束时记录被调用的函数及参数
+		shared_ptr<TailCall> tail_call;
+
 		// value用于赋值给一个变量
 		shared_ptr<unique_ptr<Data>> value;
 		shared_ptr<Error> error;
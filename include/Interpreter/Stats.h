@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <ostream>
+
+namespace Basic
+{
+	// Data的具体类型，用于按类型统计分配次数
+	enum class DataKind
+	{
+		DATA, // 未定义值
+		NUMBER,
+		STRING,
+		LIST,
+		DICT,
+		FUNCTION,
+		BUILTIN,
+		COUNT
+	};
+
+	// 运行时计数器，始终开启，每次只是一次自增
+	// 脚本中通过STATS()读取，命令行--stats在退出时输出
+	class Stats
+	{
+	public:
+		// 符号表查找按向上查找的层数分桶，最后一桶包含更深的层数
+		static const size_t LOOKUP_DEPTHS = 8;
+
+		static void allocated(DataKind kind)
+		{
+			allocations[static_cast<size_t>(kind)]++;
+		}
+
+		static void value_created()
+		{
+			if (++live > peak_live)
+				peak_live = live;
+		}
+
+		static void value_destroyed()
+		{
+			live--;
+		}
+
+		static void cloned()
+		{
+			clones++;
+		}
+
+		// depth为找到该变量前向上查找的层数
+		static void lookup_hit(size_t depth)
+		{
+			lookup_hits[depth < LOOKUP_DEPTHS ? depth : LOOKUP_DEPTHS - 1]++;
+		}
+
+		// depth为查找到的最上一层
+		static void lookup_miss(size_t depth)
+		{
+			lookup_misses[depth < LOOKUP_DEPTHS ? depth : LOOKUP_DEPTHS - 1]++;
+		}
+
+		static void function_called()
+		{
+			function_calls++;
+		}
+
+		static void builtin_called()
+		{
+			builtin_calls++;
+		}
+
+		static const char *kind_name(DataKind kind);
+
+		// 以文本形式输出全部计数
+		static void dump(std::ostream &os);
+
+	public:
+		static uint64_t allocations[static_cast<size_t>(DataKind::COUNT)];
+		static uint64_t clones;
+		static uint64_t lookup_hits[LOOKUP_DEPTHS];
+		static uint64_t lookup_misses[LOOKUP_DEPTHS];
+		static uint64_t function_calls;
+		static uint64_t builtin_calls;
+		static int64_t live;
+		static int64_t peak_live;
+	};
+}
@@ -24,6 +24,8 @@ namespace Basic
 		SymbolTable &operator=(const SymbolTable &other);
 
 		shared_ptr<unique_ptr<Data>> get(const string &name);
+		// 只在当前层查找，返回存放变量的位置以便原地修改；不存在时返回nullptr
+		shared_ptr<unique_ptr<Data>> *find(const string &name);
 		void remove(const string &symbol);
 		void set(const string &symbol, const shared_ptr<unique_ptr<Data>> &value);
 		void setParent(const shared_ptr<SymbolTable> &);
@@ -1,6 +1,8 @@
 #pragma once
 #include <vector>
 #include <string>
+#include <cstdint>
+#include <cstring>
 
 using std::string;
 using std::vector;
@@ -8,51 +10,84 @@ using std::vector;
 // -------常量定义-------
 
 // -------符号定义-------
-const string TD_INT = "INT";
-const string TD_FLOAT = "FLOAT";
-const string TD_STRING = "STRING";
-const string TD_PLUS = "PLUS";
-const string TD_MINUS = "MINUS";
-const string TD_MUL = "MUL";
-const string TD_DIV = "DIV";
-const string TD_POW = "POW";
-const string TD_DOT = "DOT"; // '.' 用于字典对象
-const string TD_LPAREN = "LPAREN";
-const string TD_RPAREN = "RPAREN";
-const string TD_LSQUARE = "LSQUARE"; // [
-const string TD_RSQUARE = "RSQUARE"; // ]
-const string TD_LBRACE = "LBRACE";	 // {
-const string TD_RBRACE = "RBRACE";	 // }
-
-const string TD_REF = "REF";		 // &，引用符号
-const string TD_COLON = "COLON";	 // ':'
-const string TD_NEWLINE = "NEWLINE"; // 允许多行输入
-const string TD_EOF = "EOF";		 // 词法分析终止符
-
-// -------布尔运算-------
-const string TD_EE = "EE";	 // equal "=="
-const string TD_NE = "NE";	 // not equal "!="
-const string TD_LT = "LT";	 // less than "<"
-const string TD_GT = "GT";	 // greater than ">"
-const string TD_LTE = "LTE"; // less than equal "<="
-const string TD_GTE = "GTE"; // greater than equal ">="
-
-// -------变量-------
-const string TD_KEYWORD = "KEYWORD";
-const string TD_IDENTIFIER = "IDENTIFIER";
-const string TD_EQ = "EQ"; // assign "="
-
-// -------函数-------
-const string TD_COMMA = "COMMA"; // ,
-const string TD_ARROW = "ARROW"; // ->
+// Token的类别，与TOKEN_TYPE_NAMES一一对应
+enum TokenType : uint8_t
+{
+	TD_INT,
+	TD_FLOAT,
+	TD_STRING,
+	TD_PLUS,
+	TD_MINUS,
+	TD_MUL,
+	TD_DIV,
+	TD_POW,
+	TD_DOT, // '.' 用于字典对象
+	TD_LPAREN,
+	TD_RPAREN,
+	TD_LSQUARE, // [
+	TD_RSQUARE, // ]
+	TD_LBRACE,	// {
+	TD_RBRACE,	// }
 
-// 词法分析常量
+	TD_REF,		// &，引用符号
+	TD_COLON,	// ':'
+	TD_NEWLINE, // 允许多行输入
+	TD_EOF,		// 词法分析终止符
+
+	// -------布尔运算-------
+	TD_EE,	// equal "=="
+	TD_NE,	// not equal "!="
+	TD_LT,	// less than "<"
+	TD_GT,	// greater than ">"
+	TD_LTE, // less than equal "<="
+	TD_GTE, // greater than equal ">="
+
+	// -------变量-------
+	TD_KEYWORD,
+	TD_IDENTIFIER,
+	TD_EQ, // assign "="
+
+	// -------函数-------
+	TD_COMMA, // ,
+	TD_ARROW  // ->
+};
 
-const vector<char> SIGNS{'+', '-', '*', '/', '(', ')', '[', ']', '{', '}', ':', '^', '=', '!', '<', '>', ',', '.', '\"', '&'};
-const vector<char> DIGITS{'0', '1', '2', '3', '4', '5', '6', '7', '8', '9'};
-const vector<char> IGNORES{' ', '\r', '\t'};
-const vector<char> NEWLINE{'\n', ';', '\0'};
-const vector<string> KEYWORDS{
+constexpr const char *TOKEN_TYPE_NAMES[] = {
+	"INT", "FLOAT", "STRING", "PLUS", "MINUS", "MUL", "DIV", "POW", "DOT",
+	"LPAREN", "RPAREN", "LSQUARE", "RSQUARE", "LBRACE", "RBRACE",
+	"REF", "COLON", "NEWLINE", "EOF",
+	"EE", "NE", "LT", "GT", "LTE", "GTE",
+	"KEYWORD", "IDENTIFIER", "EQ",
+	"COMMA", "ARROW"};
+
+static_assert(sizeof(TOKEN_TYPE_NAMES) / sizeof(TOKEN_TYPE_NAMES[0]) == TD_ARROW + 1, "TOKEN_TYPE_NAMES out of sync with TokenType");
+
+// 关键字，与KEYWORDS一一对应
+enum Keyword : uint8_t
+{
+	KW_NONE, // 不是关键字
+	KW_VAR,
+	KW_AND,
+	KW_OR,
+	KW_NOT,
+	KW_IF,
+	KW_THEN,
+	KW_ELIF,
+	KW_ELSE,
+	KW_FOR,
+	KW_TO,
+	KW_STEP,
+	KW_WHILE,
+	KW_FUNC,
+	KW_END,
+	KW_RETURN,
+	KW_CONTINUE,
+	KW_BREAK,
+	KW_DEL
+};
+
+constexpr const char *KEYWORDS[] = {
+	"",			// KW_NONE
 	"VAR",		// 声明变量
 	"AND",		// 与运算
 	"OR",		// 或运算
@@ -71,4 +106,112 @@ const vector<string> KEYWORDS{
 	"CONTINUE", // Continue loop
 	"BREAK",	// Break from loop
 	"DEL"		// Delete a variable
-};
\ No newline at end of file
+};
+
+constexpr size_t KEYWORD_COUNT = sizeof(KEYWORDS) / sizeof(KEYWORDS[0]);
+
+// 关键字的完美哈希：由首尾字符与长度决定，编译期保证没有冲突
+constexpr size_t KEYWORD_TABLE_SIZE = 64;
+
+constexpr size_t keyword_hash(const char *word, size_t length)
+{
+	return ((unsigned char)word[0] * 3 + (unsigned char)word[length - 1] * 11 + length) & (KEYWORD_TABLE_SIZE - 1);
+}
+
+constexpr size_t const_strlen(const char *str)
+{
+	size_t length = 0;
+	while (str[length] != '\0')
+		length++;
+	return length;
+}
+
+struct KeywordTable
+{
+	Keyword slots[KEYWORD_TABLE_SIZE];
+	bool perfect; // 是否无冲突
+};
+
+constexpr KeywordTable make_keyword_table()
+{
+	KeywordTable table{};
+	table.perfect = true;
+
+	for (size_t kw = KW_NONE + 1; kw < KEYWORD_COUNT; kw++)
+	{
+		size_t slot = keyword_hash(KEYWORDS[kw], const_strlen(KEYWORDS[kw]));
+		if (table.slots[slot] != KW_NONE)
+			table.perfect = false;
+		table.slots[slot] = (Keyword)kw;
+	}
+
+	return table;
+}
+
+constexpr KeywordTable KEYWORD_TABLE = make_keyword_table();
+static_assert(KEYWORD_TABLE.perfect, "keyword_hash collides, adjust its coefficients");
+
+// 查找word[0, length)对应的关键字，不是关键字时返回KW_NONE
+inline Keyword find_keyword(const char *word, size_t length)
+{
+	if (length == 0)
+		return KW_NONE;
+
+	Keyword kw = KEYWORD_TABLE.slots[keyword_hash(word, length)];
+	if (kw != KW_NONE && const_strlen(KEYWORDS[kw]) == length && std::memcmp(KEYWORDS[kw], word, length) == 0)
+		return kw;
+
+	return KW_NONE;
+}
+
+// 词法分析常量
+
+// 字符类别，一个字符可同时属于多个类别
+enum CharClass : uint8_t
+{
+	CC_IGNORE = 1 << 0,	 // 空白：' ', '\r', '\t'
+	CC_NEWLINE = 1 << 1, // 语句结束：'\n', ';', '\0'
+	CC_LETTER = 1 << 2,	 // A-Z, a-z
+	CC_DIGIT = 1 << 3,	 // 0-9
+	CC_SIGN = 1 << 4,	 // 运算符、括号与'"'
+	CC_IDENT = 1 << 5,	 // 标识符中的字符：字母、数字、'_'
+	CC_NUMBER = 1 << 6	 // 数字中的字符：数字、'.', 'e', 'E', '+', '-'
+};
+
+struct CharTable
+{
+	uint8_t classes[256];
+};
+
+constexpr CharTable make_char_table()
+{
+	CharTable table{};
+
+	for (const char *p = " \r\t"; *p; p++)
+		table.classes[(unsigned char)*p] |= CC_IGNORE;
+	for (const char *p = "\n;"; *p; p++)
+		table.classes[(unsigned char)*p] |= CC_NEWLINE;
+	table.classes[0] |= CC_NEWLINE;
+
+	for (int ch = 'A'; ch <= 'Z'; ch++)
+		table.classes[ch] |= CC_LETTER | CC_IDENT;
+	for (int ch = 'a'; ch <= 'z'; ch++)
+		table.classes[ch] |= CC_LETTER | CC_IDENT;
+	for (int ch = '0'; ch <= '9'; ch++)
+		table.classes[ch] |= CC_DIGIT | CC_IDENT | CC_NUMBER;
+	table.classes[(unsigned char)'_'] |= CC_IDENT;
+
+	for (const char *p = "+-*/()[]{}:^=!<>,.\"&"; *p; p++)
+		table.classes[(unsigned char)*p] |= CC_SIGN;
+	for (const char *p = ".eE+-"; *p; p++)
+		table.classes[(unsigned char)*p] |= CC_NUMBER;
+
+	return table;
+}
+
+constexpr CharTable CHAR_TABLE = make_char_table();
+
+inline bool char_is(char ch, uint8_t char_class)
+{
+	return (CHAR_TABLE.classes[(unsigned char)ch] & char_class) != 0;
+}
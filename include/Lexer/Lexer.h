@@ -19,6 +19,11 @@ namespace Basic
 		void advance();
 		void skip_comment();
 
+		// 跳过一串同属char_class的字符（不含换行），返回跳过的个数
+		size_t advance_run(uint8_t char_class);
+		// 跳过count个已知不含换行的字符
+		void advance_by(size_t count);
+
 		vector<Token> make_tokens();
 
 		Token make_sign();
@@ -35,8 +40,7 @@ namespace Basic
 		Token make_greater_than();
 
 	private:
-		string text;
-		string filename;
+		string_view text; // 指向SourceRegistry中的源码，以'\0'结尾
 		Position pos;
 		char current_char;
 	};
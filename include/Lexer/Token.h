@@ -1,36 +1,45 @@
 #pragma once
 #include <string>
+#include <string_view>
 #include "Common/Position.h"
 #include "Constant.h"
 
 using std::string;
+using std::string_view;
 
 namespace Basic
 {
+	// Token可以直接按值拷贝，其文本指向SourceRegistry中的源码
 	class Token
 	{
 	public:
-		// KEYWORD & IDENTIFIER
-		Token(const string &type_, const string &value_, const Position &start = Position(), const Position &end = Position());
+		// IDENTIFIER & STRING
+		Token(TokenType type_, string_view value_, const Position &start = Position(), const Position &end = Position());
 
-		// DIGIT & SIGN
-		Token(const string &type_ = "", double value_ = 0, const Position &start = Position(), const Position &end = Position());
+		// KEYWORD
+		Token(Keyword keyword_, const Position &start = Position(), const Position &end = Position());
 
-		// COPY
-		Token(const Token &);
+		// DIGIT & SIGN
+		Token(TokenType type_ = TD_EOF, double value_ = 0, const Position &start = Position(), const Position &end = Position());
 
 		// 仅判断类别和值是否相同
 		bool operator==(const Token &other) const;
 
-		bool matches(const string &, const string &);
+		// 是否为给定的关键字
+		bool matches(Keyword keyword_) const
+		{
+			return this->keyword == keyword_;
+		}
 
 		void set_pos(const Position &start, const Position &end);
-		double get_number();
-		string repr();
+		double get_number() const;
+		string repr() const;
 
-		string type;
-		string value;
+		TokenType type;
+		Keyword keyword; // 仅KEYWORD有效，其余为KW_NONE
+		double number;	 // 仅INT、FLOAT有效
 		Position pos_start;
 		Position pos_end;
+		string_view value; // 仅IDENTIFIER、STRING有效
 	};
 }
\ No newline at end of file
@@ -0,0 +1,81 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <cstdint>
+#include <cstddef>
+
+using std::shared_ptr;
+using std::unique_ptr;
+using std::vector;
+
+namespace Basic
+{
+	// 存放在AstArena中的定长数组，只保存首地址与长度
+	template <class T>
+	class ArenaList
+	{
+	public:
+		ArenaList() = default;
+		ArenaList(T *items, uint32_t count) : items(items), count(count) {}
+
+		T *begin() const { return items; }
+		T *end() const { return items + count; }
+		T &operator[](size_t i) const { return items[i]; }
+		T &back() const { return items[count - 1]; }
+		size_t size() const { return count; }
+		bool empty() const { return count == 0; }
+
+	private:
+		T *items = nullptr;
+		uint32_t count = 0;
+	};
+
+	// 语法树的内存池：结点在大块内存中连续分配，互相以裸指针链接
+	// 结点均不需要析构，整棵树随内存池一次性释放
+	class AstArena
+	{
+	public:
+		AstArena() = default;
+		AstArena(const AstArena &) = delete;
+		AstArena &operator=(const AstArena &) = delete;
+
+		template <class T, class... Args>
+		T *make(Args &&...args)
+		{
+			static_assert(std::is_trivially_destructible<T>::value, "AstArena never runs destructors");
+			return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+		}
+
+		template <class T>
+		ArenaList<T> copy(const vector<T> &items)
+		{
+			static_assert(std::is_trivially_destructible<T>::value, "AstArena never runs destructors");
+			if (items.empty())
+				return ArenaList<T>();
+
+			T *data = static_cast<T *>(allocate(sizeof(T) * items.size(), alignof(T)));
+			std::uninitialized_copy(items.begin(), items.end(), data);
+			return ArenaList<T>(data, static_cast<uint32_t>(items.size()));
+		}
+
+		// 托管与语法树同生命周期、需要析构的对象（如常量池）
+		void keep(shared_ptr<void> object)
+		{
+			kept.push_back(std::move(object));
+		}
+
+		// 已分配的字节数（含对齐的空隙）
+		size_t bytes_used() const;
+
+	private:
+		void *allocate(size_t size, size_t align);
+
+		vector<unique_ptr<char[]>> blocks;
+		vector<shared_ptr<void>> kept;
+		char *cursor = nullptr;
+		char *limit = nullptr;
+		size_t used = 0;
+	};
+}
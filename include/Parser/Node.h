@@ -1,21 +1,28 @@
 #pragma once
 #include "Lexer/Token.h"
+#include "AstArena.h"
 #include <memory>
 #include <tuple>
 #include <map>
 
 using std::map;
+using std::pair;
 using std::shared_ptr;
 using std::tuple;
 
 namespace Basic
 {
+	class Data;
+
+	// 常量池中的值，树遍历模式下由ConstantFolder填入字面量结点
+	using ConstantPtr = const shared_ptr<unique_ptr<Data>> *;
+
 	// 结点基类
+	// 结点都分配在AstArena中，子结点以裸指针链接，不会被单独析构
 	class ASTNode
 	{
 	public:
 		virtual string repr() = 0;
-		virtual ~ASTNode() = default;
 
 	public:
 		Position pos_start;
@@ -31,9 +38,12 @@ namespace Basic
 		string repr();
 
 		Token &get_tok();
+		ConstantPtr get_constant();
+		void set_constant(ConstantPtr constant);
 
 	private:
 		Token tok;
+		ConstantPtr constant = nullptr;
 	};
 
 	// 字符串结点
@@ -45,68 +55,75 @@ namespace Basic
 		string repr();
 
 		Token &get_tok();
+		ConstantPtr get_constant();
+		void set_constant(ConstantPtr constant);
 
 	private:
 		Token tok;
+		ConstantPtr constant = nullptr;
 	};
 
 	// 列表结点
 	class ListNode : public ASTNode
 	{
 	public:
-		ListNode(const vector<shared_ptr<ASTNode>> &elem_nodes, const Position &start = Position(), const Position &end = Position());
+		ListNode(const ArenaList<ASTNode *> &elem_nodes, const Position &start = Position(), const Position &end = Position());
 		~ListNode() = default;
 
-		const vector<shared_ptr<ASTNode>> &get_element_nodes();
+		const ArenaList<ASTNode *> &get_element_nodes();
+		// 值不会被使用时（如循环体中的语句块）只求值各元素，不构造列表
+		bool is_return_null();
+		void set_return_null(bool return_null);
 		string repr();
 
 	private:
-		vector<shared_ptr<ASTNode>> element_nodes;
+		ArenaList<ASTNode *> element_nodes;
+		bool return_null = false;
 	};
 
-	// 词典结点
+	// 词典结点，键值对按源码中的顺序排列
 	class DictNode : public ASTNode
 	{
 	public:
-		DictNode(const map<string, shared_ptr<ASTNode>> &elem, const Position &start = Position(), const Position &end = Position());
+		DictNode(const ArenaList<pair<string_view, ASTNode *>> &elem, const Position &start = Position(), const Position &end = Position());
 		~DictNode() = default;
 
-		const map<string, shared_ptr<ASTNode>> &get_elements();
+		const ArenaList<pair<string_view, ASTNode *>> &get_elements();
 
 		string repr();
 
 	private:
-		map<string, shared_ptr<ASTNode>> elements;
+		ArenaList<pair<string_view, ASTNode *>> elements;
 	};
 
 	// 索引节点，e.g. list[1]
 	class IndexNode : public ASTNode
 	{
 	public:
-		IndexNode(const shared_ptr<ASTNode> &value, const shared_ptr<ASTNode> &index);
+		IndexNode(ASTNode *value, ASTNode *index);
 		~IndexNode() = default;
 
-		const shared_ptr<ASTNode> &get_value();
-		const shared_ptr<ASTNode> &get_index();
+		ASTNode *&get_value();
+		ASTNode *&get_index();
 		string repr();
 
 	private:
-		shared_ptr<ASTNode> value;
-		shared_ptr<ASTNode> index;
+		ASTNode *value;
+		ASTNode *index;
 	};
 
 	class AttrNode : public ASTNode
 	{
 	public:
-		AttrNode(const shared_ptr<ASTNode> &elem, const Token &attr);
+		AttrNode(ASTNode *elem, const Token &attr);
 		~AttrNode() = default;
 
-		const shared_ptr<ASTNode> &get_elem();
+		ASTNode *&get_elem();
 		const Token &get_attr();
 		string repr();
 
 	private:
-		shared_ptr<ASTNode> elem;
+		ASTNode *elem;
 		Token attr;
 	};
 
@@ -114,34 +131,34 @@ namespace Basic
 	class BinOpNode : public ASTNode
 	{
 	public:
-		BinOpNode(const shared_ptr<ASTNode> &_left, const Token &_op, const shared_ptr<ASTNode> &_right);
+		BinOpNode(ASTNode *_left, const Token &_op, ASTNode *_right);
 		~BinOpNode() = default;
 		string repr();
 
-		const shared_ptr<ASTNode> &get_left();
-		const shared_ptr<ASTNode> &get_right();
+		ASTNode *&get_left();
+		ASTNode *&get_right();
 		Token &get_op();
 
 	private:
 		Token op;
-		shared_ptr<ASTNode> left;
-		shared_ptr<ASTNode> right;
+		ASTNode *left;
+		ASTNode *right;
 	};
 
 	// 一元运算结点
 	class UnaryOpNode : public ASTNode
 	{
 	public:
-		UnaryOpNode(const Token &_op, const shared_ptr<ASTNode> &_node);
+		UnaryOpNode(const Token &_op, ASTNode *_node);
 		~UnaryOpNode() = default;
 		string repr();
 
 		Token &get_op();
-		const shared_ptr<ASTNode> &get_node();
+		ASTNode *&get_node();
 
 	private:
 		Token op;
-		shared_ptr<ASTNode> node;
+		ASTNode *node;
 	};
 
 	// 访问变量结点
@@ -161,78 +178,90 @@ namespace Basic
 	class VarReferenceNode : public ASTNode
 	{
 	public:
-		VarReferenceNode(const shared_ptr<ASTNode> &var);
+		VarReferenceNode(ASTNode *var);
 		~VarReferenceNode() = default;
 		string repr();
 
-		const shared_ptr<ASTNode> &get_variable();
+		ASTNode *&get_variable();
 
 	private:
-		shared_ptr<ASTNode> variable;
+		ASTNode *variable;
 	};
 
 	// 可变值节点（不同于Assign，这将直接修改地址指向的值）
 	class MutateNode : public ASTNode
 	{
 	public:
-		MutateNode(const shared_ptr<ASTNode> &mutant, const shared_ptr<ASTNode> &value);
+		MutateNode(ASTNode *mutant, ASTNode *value);
 		~MutateNode() = default;
 
 		string repr();
 
-		const shared_ptr<ASTNode> &get_mutant();
-		const shared_ptr<ASTNode> &get_value();
+		ASTNode *&get_mutant();
+		ASTNode *&get_value();
 
 	private:
-		shared_ptr<ASTNode> mutant; // 要改变的变量
-		shared_ptr<ASTNode> value;	// 给定的新值
+		ASTNode *mutant; // 要改变的变量
+		ASTNode *value;	// 给定的新值
 	};
 
 	class DefineNode : public ASTNode
 	{
 	public:
-		DefineNode(const Token &var_name_tok, const shared_ptr<ASTNode> &value_node);
+		DefineNode(const Token &var_name_tok, ASTNode *value_node);
 		~DefineNode() = default;
 		string repr();
 
 		Token &get_var_name_tok();
-		const shared_ptr<ASTNode> &get_value_node();
+		ASTNode *&get_value_node();
 
 	private:
 		Token var_name_tok;
-		shared_ptr<ASTNode> value_node;
+		ASTNode *value_node;
 	};
 
 	// 变量赋值结点
 	class VarAssignNode : public ASTNode
 	{
 	public:
-		VarAssignNode(const vector<shared_ptr<ASTNode>> &assignments, const Position &start = Position(), const Position &end = Position());
+		VarAssignNode(const ArenaList<ASTNode *> &assignments, const Position &start = Position(), const Position &end = Position());
 		~VarAssignNode() = default;
 		string repr();
 
-		const vector<shared_ptr<ASTNode>> &get_assignments();
+		const ArenaList<ASTNode *> &get_assignments();
 
 	private:
-		vector<shared_ptr<ASTNode>> assignments;
+		ArenaList<ASTNode *> assignments;
 	};
 
 	// 删除变量结点
 	class VarDeleteNode : public ASTNode
 	{
 	public:
-		VarDeleteNode(const vector<Token> &deletion, const Position &start = Position(), const Position &end = Position());
+		VarDeleteNode(const ArenaList<Token> &deletion, const Position &start = Position(), const Position &end = Position());
 		~VarDeleteNode() = default;
 		string repr();
 
-		const vector<Token> &get_deletion();
+		const ArenaList<Token> &get_deletion();
 
 	private:
-		vector<Token> deletion;
+		ArenaList<Token> deletion;
+	};
+
+	struct If_Case
+	{
+		ASTNode *condition;
+		ASTNode *expr;
+		bool return_null; // 多行分支不可做为赋值语句的expr
+	};
+
+	struct Else_Case
+	{
+		ASTNode *expr = nullptr;
+		bool return_null = false;
 	};
 
-	using Cases = vector<tuple<shared_ptr<ASTNode>, shared_ptr<ASTNode>, bool>>;
-	using Else_Case = tuple<shared_ptr<ASTNode>, bool>;
+	using Cases = ArenaList<If_Case>;
 
 	// If结点
 	class IfNode : public ASTNode
@@ -246,9 +275,7 @@ namespace Basic
 		Else_Case &get_else_case();
 
 	private:
-		// Case: condition, expr, is_return_null
 		Cases cases;
-		// Else_Case: expr, is_return_null
 		Else_Case else_case;
 	};
 
@@ -256,23 +283,24 @@ namespace Basic
 	class ForNode : public ASTNode
 	{
 	public:
-		ForNode(const Token &var_name, const shared_ptr<ASTNode> &start_value_node, const shared_ptr<ASTNode> &end_value_node, const shared_ptr<ASTNode> &body_node, const shared_ptr<ASTNode> &step_value_node = nullptr, bool return_null = false);
+		ForNode(const Token &var_name, ASTNode *start_value_node, ASTNode *end_value_node, ASTNode *body_node, ASTNode *step_value_node = nullptr, bool return_null = false);
 		~ForNode() = default;
 		string repr();
 
 		Token &get_var_name_tok();
-		const shared_ptr<ASTNode> &get_start_value_node();
-		const shared_ptr<ASTNode> &get_end_value_node();
-		const shared_ptr<ASTNode> &get_body_node();
-		const shared_ptr<ASTNode> &get_step_value_node();
+		ASTNode *&get_start_value_node();
+		ASTNode *&get_end_value_node();
+		ASTNode *&get_body_node();
+		ASTNode *&get_step_value_node();
 		bool is_return_null();
+		void set_return_null(bool return_null);
 
 	private:
 		Token var_name_tok;
-		shared_ptr<ASTNode> start_value_node; // 循环起始
-		shared_ptr<ASTNode> end_value_node;	  // 循环终点
-		shared_ptr<ASTNode> body_node;		  // 循环主体
-		shared_ptr<ASTNode> step_value_node;  // 循环步长，默认为1
+		ASTNode *start_value_node; // 循环起始
+		ASTNode *end_value_node;	  // 循环终点
+		ASTNode *body_node;		  // 循环主体
+		ASTNode *step_value_node;  // 循环步长，默认为1
 		bool return_null;					  // 多行循环结构不可做为赋值语句的expr
 	};
 
@@ -280,17 +308,18 @@ namespace Basic
 	class WhileNode : public ASTNode
 	{
 	public:
-		WhileNode(const shared_ptr<ASTNode> &condition, const shared_ptr<ASTNode> &body_node, bool return_null = false);
+		WhileNode(ASTNode *condition, ASTNode *body_node, bool return_null = false);
 		~WhileNode() = default;
 		string repr();
 
-		const shared_ptr<ASTNode> &get_condition_node();
-		const shared_ptr<ASTNode> &get_body_node();
+		ASTNode *&get_condition_node();
+		ASTNode *&get_body_node();
 		bool is_return_null();
+		void set_return_null(bool return_null);
 
 	private:
-		shared_ptr<ASTNode> condition_node;
-		shared_ptr<ASTNode> body_node;
+		ASTNode *condition_node;
+		ASTNode *body_node;
 		bool return_null;
 	};
 
@@ -298,20 +327,20 @@ namespace Basic
 	class FuncDefNode : public ASTNode
 	{
 	public:
-		FuncDefNode(const Token &var_name, const vector<Token> &arg_name_toks, const shared_ptr<ASTNode> &body_node, bool anonymous = false, bool auto_return = true);
+		FuncDefNode(const Token &var_name, const ArenaList<Token> &arg_name_toks, ASTNode *body_node, bool anonymous = false, bool auto_return = true);
 		~FuncDefNode() = default;
 		string repr();
 
 		Token &get_var_name_tok();
-		const vector<Token> &get_arg_name_toks();
-		const shared_ptr<ASTNode> &get_body_node();
+		const ArenaList<Token> &get_arg_name_toks();
+		ASTNode *&get_body_node();
 		bool isAnonymous();
 		bool is_auto_return();
 
 	private:
 		Token var_name_tok; // 允许匿名函数，所以会给默认值
-		vector<Token> arg_name_toks;
-		shared_ptr<ASTNode> body_node;
+		ArenaList<Token> arg_name_toks;
+		ASTNode *body_node;
 		bool anonymous;
 		bool auto_return; // 如果函数没有return语句则为auto return
 	};
@@ -320,29 +349,33 @@ namespace Basic
 	class CallNode : public ASTNode
 	{
 	public:
-		CallNode(const shared_ptr<ASTNode> &node_to_call, const vector<shared_ptr<ASTNode>> &arg_nodes);
+		CallNode(ASTNode *node_to_call, const ArenaList<ASTNode *> &arg_nodes);
 		~CallNode() = default;
 		string repr();
 
-		const shared_ptr<ASTNode> &get_func_node();
-		const vector<shared_ptr<ASTNode>> &get_args_nodes();
+		ASTNode *&get_func_node();
+		const ArenaList<ASTNode *> &get_args_nodes();
+		// 位于尾部的调用（其值即为所在函数的返回值）可以复用当前函数的调用层
+		bool is_tail();
+		void set_tail(bool tail);
 
 	private:
-		shared_ptr<ASTNode> func;
-		vector<shared_ptr<ASTNode>> args;
+		ASTNode *func;
+		ArenaList<ASTNode *> args;
+		bool tail = false;
 	};
 
 	class ReturnNode : public ASTNode
 	{
 	public:
-		ReturnNode(const shared_ptr<ASTNode> &node_to_return, const Position &start = Position(), const Position &end = Position());
+		ReturnNode(ASTNode *node_to_return, const Position &start = Position(), const Position &end = Position());
 		ReturnNode() = default;
 		string repr();
 
-		const shared_ptr<ASTNode> &get_return_node();
+		ASTNode *&get_return_node();
 
 	private:
-		shared_ptr<ASTNode> node_to_return;
+		ASTNode *node_to_return;
 	};
 
 	class ContinueNode : public ASTNode
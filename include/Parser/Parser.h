@@ -1,56 +1,55 @@
 #pragma once
 
 #include "Lexer/Token.h"
-#include "Parse_Result.h"
 #include "Node.h"
-#include <functional>
-
-using std::function;
 
 namespace Basic
 {
+	// 递归下降 + 优先级爬升(Pratt)的语法分析器
+	// 只向前看一个Token，不回退；遇到语法错误时抛出InvalidSyntaxError
 	class Parser
 	{
 	public:
-		Parser(const vector<Token> &toks);
+		// 接管Token数组，解析过程中不再拷贝Token
+		Parser(vector<Token> &&toks);
 		void advance();
-		void reverse(int amount = 1);
-		Parse_Result parse();
+		ASTNode *parse();
 
-		Parse_Result func_def(); // 函数定义
+		// 语法树所在的内存池，树的生命周期由它决定
+		const shared_ptr<AstArena> &get_arena() const;
 
-		Parse_Result while_expr(); // while循环
-		Parse_Result for_expr();   // for循环
+		ASTNode *func_def(); // 函数定义
 
-		Parse_Result if_expr_cases(const string &); // if条件语句
-		Parse_Result elif_or_else_expr();			// elxx语句
-		Parse_Result else_expr();					// else语句
-		Parse_Result elif_expr();					// elif语句
-		Parse_Result if_expr();						// if语句
+		ASTNode *while_expr(); // while循环
+		ASTNode *for_expr();   // for循环
 
-		Parse_Result list_expr(); // 列表
-		Parse_Result dict_expr(); // 字典
-		Parse_Result atom();	  // 原子项，包含以上所有节点
-		Parse_Result index();	  // 索引语句，可以对列表索引
-		Parse_Result ref();		  // 引用变量，表示对变量的引用
-		Parse_Result call();	  // 调用语句
+		void if_expr_cases(Keyword, vector<If_Case> &, Else_Case &); // if/elif分支，结果追加到cases中
+		void else_expr(Else_Case &);								 // else语句
+		ASTNode *if_expr();											 // if语句
 
-		Parse_Result power();	   // 幂运算
-		Parse_Result factor();	   // 单元运算
-		Parse_Result term();	   // 乘除运算
-		Parse_Result arith_expr(); // 加减运算
-		Parse_Result comp_expr();  // 布尔运算
+		ASTNode *list_expr(); // 列表
+		ASTNode *dict_expr(); // 字典
+		ASTNode *atom();	  // 原子项，包含以上所有节点
+		ASTNode *index();	  // 索引语句，可以对列表索引
+		ASTNode *ref();		  // 引用变量，表示对变量的引用
+		ASTNode *call();	  // 调用语句
 
-		Parse_Result expr();	   // 表达式
-		Parse_Result statement();  // 单条语句
-		Parse_Result statements(); // 语句合集
+		ASTNode *power();			   // 幂运算（右结合）
+		ASTNode *factor();			   // 单元运算
+		ASTNode *binary(int min_prec); // 二元运算，只处理优先级不低于min_prec的运算符
 
-		Parse_Result bin_op(function<Parse_Result(Parser *)>, const vector<string> &ops, function<Parse_Result(Parser *)>);
-		Parse_Result bin_op(function<Parse_Result(Parser *)>, const vector<Token> &ops, function<Parse_Result(Parser *)>);
+		ASTNode *expr();	   // 表达式
+		ASTNode *statement();  // 单条语句
+		ASTNode *statements(); // 语句合集
 
 	private:
+		[[noreturn]] void error(const string &details) const;
+		// 跳过换行后若为给定关键字则停在该处，否则不移动
+		bool skip_newlines_before(Keyword a, Keyword b);
+
+		shared_ptr<AstArena> arena;
 		vector<Token> tokens;
-		int tok_idx;
-		Token current_tok;
+		size_t tok_idx;
+		const Token *current_tok; // 指向tokens[tok_idx]
 	};
-}
\ No newline at end of file
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include "Interpreter/Data.h"
+#include "VM/Value.h"
+
+using std::shared_ptr;
+using std::vector;
+
+namespace Basic
+{
+	class Chunk;
+
+	// 一次函数调用的局部变量
+	// 变量按编译期分配的槽位存放，parent指向定义该函数时所在的环境
+	// 树遍历解释器中的函数没有chunk与槽位，只用symbols记录定义时的变量表
+	class Environment
+	{
+	public:
+		Environment(const shared_ptr<Chunk> &chunk, const shared_ptr<Environment> &parent, const shared_ptr<SymbolTable> &symbols);
+
+		// 沿parent向上depth层
+		Environment *ancestor(uint32_t depth);
+
+	public:
+		vector<Value> slots;		 // Number内联存放；undefined表示尚未定义或已被DEL
+		shared_ptr<Chunk> chunk;	 // 函数体，其中记录了各槽位的变量名
+		shared_ptr<Environment> parent;
+		shared_ptr<SymbolTable> symbols; // 不在槽位中的变量（顶层变量、DEL与RUN等）
+	};
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <optional>
+#include "Common/Context.h"
+#include "Common/Profiler.h"
+#include "Common/Tracer.h"
+#include "Compiler/Chunk.h"
+#include "Interpreter/RuntimeResult.h"
+#include "Interpreter/Data.h"
+#include "Value.h"
+#include "Environment.h"
+
+using std::deque;
+using std::vector;
+
+namespace Basic
+{
+	// 基于栈的字节码虚拟机，执行Compiler生成的Chunk
+	class VM
+	{
+	public:
+		// env为函数调用的局部变量，顶层代码为空
+		RuntimeResult run(const shared_ptr<Chunk> &chunk, Context &context, const shared_ptr<Environment> &env = nullptr);
+
+	private:
+		// 不常用的调用状态，只在经MEMO调用或开启分析器时分配
+		struct FrameExtra
+		{
+			shared_ptr<MemoCache> memo; // 经MEMO函数调用时，返回值以memo_key写入此缓存
+			string memo_key;
+			std::optional<Profiler::Scope> profile_scope;
+			std::optional<Tracer::Scope> trace_scope;
+		};
+
+		// 一次调用的状态。字节码函数之间的调用只在frames中压入一帧，不占用C++栈
+		struct Frame
+		{
+			// 最外层的帧，执行run传入的代码
+			Frame(Chunk *chunk, Context &context, const shared_ptr<Environment> &env);
+			// 调用func，context为本次调用的上下文，call_pos为调用处
+			Frame(const DataPtr &callee, Function *func, Context &context, const Position &call_pos, size_t stack_base, size_t for_base);
+
+			DataPtr callee; // 保持被调用的函数存活
+			Chunk *chunk;	// 由callee或run的调用者保持存活
+			shared_ptr<Environment> env;   // 局部变量，顶层代码为空
+			shared_ptr<Environment> scope; // 在此定义的函数所引用的环境
+			Context *context;	// 最外层为run传入的context，其余为contexts中的一项
+			size_t ip = 0;
+			size_t stack_base = 0; // 进入时栈与FOR计数器的高度，返回时恢复到此
+			size_t for_base = 0;
+			bool auto_return = true;
+			unique_ptr<FrameExtra> extra;
+
+			MemoCache *memo() const { return extra != nullptr ? extra->memo.get() : nullptr; }
+		};
+
+		RuntimeResult execute();
+		// 调用字节码函数：检查层数与参数，压入新的一帧
+		// call_pos为错误栈中记录的调用位置，出错时报告在call_start到call_end（本次调用处）
+		RuntimeResult push_frame(const DataPtr &callee, vector<DataPtr> &args, Context &parent, const Position &call_pos, const Position &call_start, const Position &call_end);
+		// 当前帧返回value，弹出后将结果放到调用者的栈顶
+		void pop_frame(DataPtr value, bool explicit_return);
+		// 弹出当前帧，恢复栈与FOR计数器的高度
+		void drop_frame();
+
+		// 将值装箱为DataPtr，Number与常量池中的值会按其源码区间恢复位置
+		DataPtr box(const Value &value, Chunk &chunk, Context &context);
+		// 对两个内联数值做二元运算
+		Value number_binop(const Instruction &ins, const Value &left, const Value &right, uint32_t span, Chunk &chunk, Context &context);
+
+		// FOR循环的计数器
+		struct ForState
+		{
+			int64_t i;
+			int64_t end;
+			int64_t step;
+			bool done; // 计数器再前进会溢出，循环已结束
+		};
+
+		shared_ptr<Chunk> root_chunk; // run传入的代码，最外层帧中定义的函数引用它
+		vector<Value> stack;
+		vector<ForState> for_states;
+		deque<Frame> frames;
+		// 各层调用的上下文，第i层调用（frames[i]）使用contexts[i - 1]
+		// 与frames一同在末尾压入、弹出，其余项的地址保持不变
+		deque<Context> contexts;
+	};
+}
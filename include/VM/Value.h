@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include "Interpreter/Data.h"
+
+namespace Basic
+{
+	// 虚拟机栈与局部变量槽位中的值
+	// Number直接以double内联存储，不做任何堆分配；其余类型仍为堆上的Data
+	// 只有在写入全局变量、容器或传给函数时，Number才会被装箱为DataPtr
+	// 常量池中的值同样直接共享，装箱时才拷贝一份并设置位置与上下文
+	class Value
+	{
+	public:
+		Value() : number(0), span(0) {}
+		Value(double number, uint32_t span) : number(number), span(span) {}
+		Value(const DataPtr &object) : number(0), span(0), object(object) {}
+		Value(DataPtr &&object) : number(0), span(0), object(std::move(object)) {}
+		// 常量池中的值，span为CONSTANT指令的源码区间
+		Value(const DataPtr &constant, uint32_t span) : number(0), span(span), object(constant), pooled(true) {}
+
+		// 槽位中尚未定义或已被DEL的变量
+		static Value undefined()
+		{
+			Value value;
+			value.defined = false;
+			return value;
+		}
+
+		bool is_number() const { return object == nullptr; }
+		bool is_defined() const { return defined; }
+
+	public:
+		double number;
+		uint32_t span;	// 产生该数值或常量的源码区间下标，装箱时据此恢复位置
+		DataPtr object; // 为空时表示内联的Number
+		bool pooled = false; // object属于常量池，不能修改，也不能存入变量或容器
+		bool defined = true; // 只有槽位会为false
+	};
+}
@@ -1,12 +1,25 @@
 #include "Common/Context.h"
 
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
 namespace Basic
 {
-	Context::Context(const string &display_name, const shared_ptr<Context> &parent, const Position &parent_entry_pos)
+	size_t Context::max_depth = 100000;
+	uintptr_t Context::stack_base = 0;
+	size_t Context::stack_budget = 0;
+
+	// 留给两次检查之间的表达式求值与生成错误信息的栈空间
+	static const size_t stack_reserve = 256 * 1024;
+
+	Context::Context(const string &display_name, Context *parent, const Position &parent_entry_pos, const shared_ptr<SymbolTable> &symbol_table)
 	{
 		this->display_name = display_name;
 		this->parent = parent;
 		this->parent_entry_pos = parent_entry_pos;
+		this->symbol_table = symbol_table != nullptr ? symbol_table : make_shared<SymbolTable>();
+		this->depth = parent != nullptr ? parent->depth + 1 : 0;
 	}
 
 	Context::Context(const Context &other)
@@ -15,9 +28,10 @@ namespace Basic
 		this->parent_entry_pos = other.parent_entry_pos;
 		this->parent = other.parent;
 		this->symbol_table = other.symbol_table;
+		this->depth = other.depth;
 	}
 
-	void Context::set_symbol_table(const SymbolTable &symble_table)
+	void Context::set_symbol_table(const shared_ptr<SymbolTable> &symble_table)
 	{
 		this->symbol_table = symble_table;
 	}
@@ -32,13 +46,59 @@ namespace Basic
 		return this->parent_entry_pos;
 	}
 
-	const shared_ptr<Context> &Context::get_parent()
+	Context *Context::get_parent()
 	{
 		return this->parent;
 	}
 
 	SymbolTable &Context::get_symbol_table()
+	{
+		return *this->symbol_table;
+	}
+
+	const shared_ptr<SymbolTable> &Context::get_shared_symbol_table()
 	{
 		return this->symbol_table;
 	}
-}
\ No newline at end of file
+
+	size_t Context::get_depth()
+	{
+		return this->depth;
+	}
+
+	void Context::set_max_depth(size_t depth)
+	{
+		max_depth = depth;
+	}
+
+	size_t Context::get_max_depth()
+	{
+		return max_depth;
+	}
+
+	void Context::mark_stack_base()
+	{
+		char marker;
+		stack_base = reinterpret_cast<uintptr_t>(&marker);
+
+		size_t size = 1024 * 1024; // Windows主线程默认1MB
+#ifndef _WIN32
+		struct rlimit limit;
+		if (getrlimit(RLIMIT_STACK, &limit) == 0)
+			size = limit.rlim_cur == RLIM_INFINITY ? 0 : limit.rlim_cur;
+#endif
+		// 栈大小不受限时不做检查，只由max_depth限制
+		stack_budget = size > 2 * stack_reserve ? size - stack_reserve : size / 2;
+	}
+
+	bool Context::stack_exhausted()
+	{
+		if (stack_base == 0 || stack_budget == 0)
+			return false;
+
+		char marker;
+		uintptr_t here = reinterpret_cast<uintptr_t>(&marker);
+		size_t used = stack_base > here ? stack_base - here : here - stack_base;
+		return used > stack_budget;
+	}
+}
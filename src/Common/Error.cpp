@@ -5,8 +5,9 @@
 namespace Basic
 {
 
-	string string_with_arrows(const string &content, const Position &start, const Position &end)
+	string string_with_arrows(const Position &start, const Position &end)
 	{
+		const string &content = start.fileContent();
 		string result = "";
 
 		// indices
@@ -61,8 +62,8 @@ namespace Basic
 	string Error::as_string()
 	{
 		string result = Basic::format("%s: %s\n", this->error_name.c_str(), this->details.c_str());
-		result += Basic::format("File %s, line %s\n\n", this->pos_start.fileName.c_str(), std::to_string(this->pos_start.row + 1).c_str());
-		result += string_with_arrows(pos_start.fileContent, pos_start, pos_end);
+		result += Basic::format("File %s, line %s\n\n", this->pos_start.fileName().c_str(), std::to_string(this->pos_start.row + 1).c_str());
+		result += string_with_arrows(pos_start, pos_end);
 
 		return result;
 	}
@@ -0,0 +1,67 @@
+#include "Common/MappedFile.h"
+#include <fstream>
+#include <iterator>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace Basic
+{
+	MappedFile::~MappedFile()
+	{
+		this->close();
+	}
+
+	bool MappedFile::open(const string &path)
+	{
+		this->close();
+
+#ifndef _WIN32
+		int fd = ::open(path.c_str(), O_RDONLY);
+		if (fd < 0)
+			return false;
+
+		struct stat st;
+		if (fstat(fd, &st) == 0 && st.st_size > 0)
+		{
+			void *p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (p != MAP_FAILED)
+			{
+				this->addr = static_cast<const char *>(p);
+				this->length = st.st_size;
+				::close(fd);
+				return true;
+			}
+		}
+		::close(fd);
+#endif
+
+		std::ifstream ifs(path, std::ios::binary);
+		if (!ifs)
+			return false;
+		this->fallback.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+		return true;
+	}
+
+	void MappedFile::close()
+	{
+#ifndef _WIN32
+		if (this->addr != nullptr)
+			munmap(const_cast<char *>(this->addr), this->length);
+#endif
+		this->addr = nullptr;
+		this->length = 0;
+		this->fallback.clear();
+	}
+
+	string_view MappedFile::data() const
+	{
+		if (this->addr != nullptr)
+			return string_view(this->addr, this->length);
+		return this->fallback;
+	}
+}
@@ -3,22 +3,65 @@
 namespace Basic
 {
 
-	Position::Position(int idx, int line, int col, const string &filename, const string &ftx)
+	uint32_t SourceRegistry::add(const string &filename, const string &content)
 	{
-		this->index = idx;
-		this->row = line;
-		this->column = col;
-		this->fileName = filename;
-		this->fileContent = ftx;
+		deque<pair<string, string>> &entries = sources();
+		map<string, uint32_t> &last = latest();
+
+		// RUN同一个文件多次时不必重复保存
+		auto it = last.find(filename);
+		if (it != last.end() && entries[it->second].second == content)
+			return it->second;
+
+		entries.push_back(make_pair(filename, content));
+		last[filename] = entries.size() - 1;
+
+		return entries.size() - 1;
+	}
+
+	const string &SourceRegistry::get_name(uint32_t file_id)
+	{
+		return sources()[file_id].first;
 	}
 
-	Position::Position(const Position &other)
+	const string &SourceRegistry::get_content(uint32_t file_id)
 	{
-		this->column = other.column;
-		this->row = other.row;
-		this->index = other.index;
-		this->fileName = other.fileName;
-		this->fileContent = other.fileContent;
+		return sources()[file_id].second;
+	}
+
+	string_view SourceRegistry::keep(string text)
+	{
+		deque<string> &entries = kept();
+		entries.push_back(std::move(text));
+		return entries.back();
+	}
+
+	deque<pair<string, string>> &SourceRegistry::sources()
+	{
+		// 0号为空文件，供默认构造的Position使用
+		// 使用deque，追加时已有的内容不会移动
+		static deque<pair<string, string>> entries{{"", ""}};
+		return entries;
+	}
+
+	map<string, uint32_t> &SourceRegistry::latest()
+	{
+		static map<string, uint32_t> last;
+		return last;
+	}
+
+	deque<string> &SourceRegistry::kept()
+	{
+		static deque<string> entries;
+		return entries;
+	}
+
+	Position::Position(int idx, int line, int col, uint32_t file_id)
+	{
+		this->index = idx;
+		this->row = line;
+		this->column = col;
+		this->file_id = file_id;
 	}
 
 	void Position::advance(char current_char)
@@ -33,4 +76,14 @@ namespace Basic
 		}
 	}
 
-}
\ No newline at end of file
+	const string &Position::fileName() const
+	{
+		return SourceRegistry::get_name(this->file_id);
+	}
+
+	const string &Position::fileContent() const
+	{
+		return SourceRegistry::get_content(this->file_id);
+	}
+
+}
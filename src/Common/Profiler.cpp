@@ -0,0 +1,184 @@
+#include "Common/Profiler.h"
+#include <chrono>
+#include <thread>
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+
+namespace Basic
+{
+	using Clock = std::chrono::steady_clock;
+
+	bool Profiler::is_active = false;
+	std::atomic<bool> Profiler::pending(false);
+	vector<Profiler::Frame> Profiler::frames;
+
+	namespace
+	{
+		struct FunctionStat
+		{
+			uint64_t calls = 0;
+			double self_us = 0;
+			double total_us = 0;
+		};
+
+		const string program_name = "<program>";
+
+		std::thread sampler;
+		std::atomic<bool> running(false);
+		Clock::time_point last_sample;
+		Clock::time_point started;
+
+		// 以函数名为键，同名函数合并统计
+		std::unordered_map<string, FunctionStat> functions;
+		// 以(文件编号, 行号)为键的自身耗时，位置未知时行号为-1
+		std::map<pair<uint32_t, int>, double> lines;
+		std::unordered_map<string, double> stacks;
+	}
+
+	void Profiler::start(int interval_us)
+	{
+		if (is_active)
+			return;
+
+		frames.clear();
+		frames.push_back(Frame{&program_name, Position()});
+		functions[program_name].calls++;
+
+		is_active = true;
+		running = true;
+		started = last_sample = Clock::now();
+
+		sampler = std::thread([interval_us]()
+							  {
+								  while (running.load(std::memory_order_relaxed))
+								  {
+									  std::this_thread::sleep_for(std::chrono::microseconds(interval_us));
+									  pending.store(true, std::memory_order_relaxed);
+								  } });
+	}
+
+	void Profiler::stop()
+	{
+		if (!is_active)
+			return;
+
+		// 最后一段时间记在顶层
+		sample(frames.back().pos);
+
+		running = false;
+		sampler.join();
+		is_active = false;
+		pending = false;
+	}
+
+	Profiler::Scope::Scope(const string &name, const Position &call_pos)
+	{
+		this->pushed = is_active;
+		if (!this->pushed)
+			return;
+
+		poll(call_pos);
+		frames.back().pos = call_pos;
+		frames.push_back(Frame{&name, call_pos});
+		functions[name].calls++;
+	}
+
+	Profiler::Scope::~Scope()
+	{
+		if (!this->pushed)
+			return;
+
+		// 内置函数（如INPUT）内部没有安全点，返回前补上这段时间
+		// 此时尚未采到函数内的位置则记在调用处，即调用本身的开销算在发起调用的行上
+		poll(frames.back().pos);
+		frames.pop_back();
+	}
+
+	void Profiler::sample(const Position &pos)
+	{
+		pending.store(false, std::memory_order_relaxed);
+
+		Clock::time_point now = Clock::now();
+		double elapsed = std::chrono::duration<double, std::micro>(now - last_sample).count();
+		last_sample = now;
+
+		frames.back().pos = pos;
+
+		functions[*frames.back().name].self_us += elapsed;
+		lines[{pos.file_id, pos.index < 0 ? -1 : pos.row}] += elapsed;
+
+		// 递归调用时同一函数只计一次总耗时（每次调用的函数对象不同，按名称判断）
+		std::unordered_set<string_view> seen;
+		string stack;
+		for (const Frame &frame : frames)
+		{
+			if (!stack.empty())
+				stack += ';';
+			stack += *frame.name;
+
+			if (seen.insert(*frame.name).second)
+				functions[*frame.name].total_us += elapsed;
+		}
+		stacks[stack] += elapsed;
+	}
+
+	void Profiler::report(std::ostream &os)
+	{
+		double total = 0;
+		for (auto &entry : functions)
+			total += entry.second.self_us;
+		if (total <= 0)
+			total = 1;
+
+		double wall = std::chrono::duration<double, std::milli>(Clock::now() - started).count();
+		os << "\n---- Profile (" << std::fixed << std::setprecision(1) << wall << " ms) ----\n";
+
+		vector<pair<string, FunctionStat>> by_function(functions.begin(), functions.end());
+		std::sort(by_function.begin(), by_function.end(), [](const auto &a, const auto &b)
+				  { return a.second.self_us > b.second.self_us; });
+
+		os << std::setw(10) << "self ms" << std::setw(8) << "self%" << std::setw(10) << "total ms" << std::setw(10) << "calls"
+		   << "  function\n";
+		for (auto &[name, stat] : by_function)
+		{
+			os << std::setw(10) << stat.self_us / 1000 << std::setw(7) << stat.self_us * 100 / total << "%"
+			   << std::setw(10) << stat.total_us / 1000 << std::setw(10) << stat.calls << "  " << name << "\n";
+		}
+
+		vector<pair<pair<uint32_t, int>, double>> by_line(lines.begin(), lines.end());
+		std::sort(by_line.begin(), by_line.end(), [](const auto &a, const auto &b)
+				  { return a.second > b.second; });
+
+		os << "\n"
+		   << std::setw(10) << "self ms" << std::setw(8) << "self%"
+		   << "  line\n";
+		for (auto &[line, self_us] : by_line)
+		{
+			os << std::setw(10) << self_us / 1000 << std::setw(7) << self_us * 100 / total << "%  ";
+			if (line.second < 0)
+				os << "<unknown>\n";
+			else
+				os << SourceRegistry::get_name(line.first) << ":" << line.second + 1 << "\n";
+		}
+		os.unsetf(std::ios::fixed);
+	}
+
+	bool Profiler::write_collapsed(const string &path)
+	{
+		std::ofstream ofs(path, std::ios::trunc);
+		if (!ofs)
+			return false;
+
+		for (auto &[stack, us] : stacks)
+		{
+			uint64_t count = static_cast<uint64_t>(us + 0.5);
+			if (count > 0)
+				ofs << stack << " " << count << "\n";
+		}
+		return static_cast<bool>(ofs);
+	}
+}
@@ -0,0 +1,132 @@
+#include "Common/Tracer.h"
+#include <chrono>
+#include <fstream>
+#include <cstdio>
+
+namespace Basic
+{
+	using Clock = std::chrono::steady_clock;
+
+	bool Tracer::is_active = false;
+	vector<Tracer::Event> Tracer::events;
+	size_t Tracer::dropped = 0;
+
+	namespace
+	{
+		// 事件数上限，避免长时间运行的脚本耗尽内存
+		const size_t MAX_EVENTS = 2000000;
+
+		Clock::time_point started;
+
+		void write_escaped(std::ostream &os, const string &text)
+		{
+			for (char c : text)
+			{
+				switch (c)
+				{
+				case '"':
+					os << "\\\"";
+					break;
+				case '\\':
+					os << "\\\\";
+					break;
+				case '\n':
+					os << "\\n";
+					break;
+				case '\t':
+					os << "\\t";
+					break;
+				default:
+					if (static_cast<unsigned char>(c) < 0x20)
+					{
+						char buf[8];
+						std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+						os << buf;
+					}
+					else
+						os << c;
+				}
+			}
+		}
+	}
+
+	void Tracer::start()
+	{
+		events.clear();
+		dropped = 0;
+		started = Clock::now();
+		is_active = true;
+	}
+
+	double Tracer::now_us()
+	{
+		return std::chrono::duration<double, std::micro>(Clock::now() - started).count();
+	}
+
+	Tracer::Scope::Scope(const char *category, const string &name)
+	{
+		this->recording = is_active && events.size() < MAX_EVENTS;
+		if (!this->recording)
+		{
+			if (is_active)
+				dropped++;
+			return;
+		}
+
+		this->index = events.size();
+		events.push_back(Event{category, name, string(), now_us(), 0});
+	}
+
+	Tracer::Scope::Scope(const char *category, const string &name, const Position &pos) : Scope(category, name)
+	{
+		if (this->recording && pos.index >= 0)
+			this->detail(pos.fileName() + ":" + std::to_string(pos.row + 1));
+	}
+
+	Tracer::Scope::~Scope()
+	{
+		if (this->recording)
+		{
+			Event &event = events[this->index];
+			event.duration_us = now_us() - event.start_us;
+		}
+	}
+
+	void Tracer::Scope::detail(const string &text)
+	{
+		if (this->recording)
+			events[this->index].detail = text;
+	}
+
+	bool Tracer::write(const string &path)
+	{
+		is_active = false;
+
+		std::ofstream ofs(path, std::ios::trunc);
+		if (!ofs)
+			return false;
+
+		char number[64];
+		ofs << "{\"traceEvents\":[\n";
+		for (size_t i = 0; i < events.size(); i++)
+		{
+			const Event &event = events[i];
+			ofs << "{\"name\":\"";
+			write_escaped(ofs, event.name);
+			ofs << "\",\"cat\":\"" << event.category << "\",\"ph\":\"X\",\"pid\":1,\"tid\":1";
+			std::snprintf(number, sizeof(number), ",\"ts\":%.3f,\"dur\":%.3f", event.start_us, event.duration_us);
+			ofs << number;
+			if (!event.detail.empty())
+			{
+				ofs << ",\"args\":{\"detail\":\"";
+				write_escaped(ofs, event.detail);
+				ofs << "\"}";
+			}
+			ofs << "}" << (i + 1 < events.size() ? ",\n" : "\n");
+		}
+		ofs << "],\"displayTimeUnit\":\"ms\",\"otherData\":{\"dropped_events\":" << dropped << "}}\n";
+
+		events.clear();
+		return static_cast<bool>(ofs);
+	}
+}
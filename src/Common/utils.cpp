@@ -44,6 +44,40 @@ namespace Basic
 		return list;
 	}
 
+	size_t loop_count(int64_t start, int64_t end, int64_t step, size_t limit)
+	{
+		if (step == 0)
+			return start <= end ? limit : 0;
+
+		if ((step > 0 && start > end) || (step < 0 && start < end))
+			return 0;
+
+		// 以无符号数计算距离，避免相减溢出
+		uint64_t distance = step > 0 ? (uint64_t)end - (uint64_t)start : (uint64_t)start - (uint64_t)end;
+		uint64_t stride = step > 0 ? (uint64_t)step : 0 - (uint64_t)step;
+		uint64_t count = distance / stride + 1;
+		return count < limit ? count : limit;
+	}
+
+	bool loop_bound(double value, int64_t &result)
+	{
+		// [-2^63, 2^63)内的值取整后才能放入int64_t，NaN不满足任一比较
+		if (!(value >= -9223372036854775808.0 && value < 9223372036854775808.0))
+			return false;
+
+		result = (int64_t)value;
+		return true;
+	}
+
+	bool loop_advance(int64_t &i, int64_t step)
+	{
+		if (step > 0 ? i > INT64_MAX - step : i < INT64_MIN - step)
+			return false;
+
+		i += step;
+		return true;
+	}
+
 	std::optional<string> readfile(const string &file_path)
 	{
 		std::ifstream ifs;
@@ -115,6 +149,9 @@ namespace Basic
 		{(const char *)"POP_FRONT", (crossline_color_e)(CROSSLINE_FGCOLOR_BRIGHT | CROSSLINE_FGCOLOR_YELLOW), (const char *)"Remove the first elem in list(mutable)", (crossline_color_e)(CROSSLINE_FGCOLOR_BRIGHT | CROSSLINE_FGCOLOR_GREEN), (const char *)"POP_FRONT(list)", (crossline_color_e)(CROSSLINE_FGCOLOR_BRIGHT | CROSSLINE_FGCOLOR_GREEN)},
 		{(const char *)"EXTEND", (crossline_color_e)(CROSSLINE_FGCOLOR_BRIGHT | CROSSLINE_FGCOLOR_YELLOW), (const char *)"Concatenate list2 to list1(mutable)", (crossline_color_e)(CROSSLINE_FGCOLOR_BRIGHT | CROSSLINE_FGCOLOR_GREEN), (const char *)"EXTEND(list1, list2)", (crossline_color_e)(CROSSLINE_FGCOLOR_BRIGHT | CROSSLINE_FGCOLOR_GREEN)},
 		{(const char *)"SWAP", (crossline_color_e)(CROSSLINE_FGCOLOR_BRIGHT | CROSSLINE_FGCOLOR_YELLOW), (const char *)"Swap two variable, use & to pass reference", (crossline_color_e)(CROSSLINE_FGCOLOR_BRIGHT | CROSSLINE_FGCOLOR_GREEN), (const char *)"SWAP(var1, var2)", (crossline_color_e)(CROSSLINE_FGCOLOR_BRIGHT | CROSSLINE_FGCOLOR_GREEN)},
+		{(const char *)"STATS", (crossline_color_e)(CROSSLINE_FGCOLOR_BRIGHT | CROSSLINE_FGCOLOR_YELLOW), (const char *)"Runtime counters: allocations, clones, lookups, calls", (crossline_color_e)(CROSSLINE_FGCOLOR_BRIGHT | CROSSLINE_FGCOLOR_GREEN), (const char *)"STATS()", (crossline_color_e)(CROSSLINE_FGCOLOR_BRIGHT | CROSSLINE_FGCOLOR_GREEN)},
+		{(const char *)"MEMO", (crossline_color_e)(CROSSLINE_FGCOLOR_BRIGHT | CROSSLINE_FGCOLOR_YELLOW), (const char *)"Cache results of a function, keeping the size most recently used", (crossline_color_e)(CROSSLINE_FGCOLOR_BRIGHT | CROSSLINE_FGCOLOR_GREEN), (const char *)"MEMO(func, size)", (crossline_color_e)(CROSSLINE_FGCOLOR_BRIGHT | CROSSLINE_FGCOLOR_GREEN)},
+		{(const char *)"MEMO_STATS", (crossline_color_e)(CROSSLINE_FGCOLOR_BRIGHT | CROSSLINE_FGCOLOR_YELLOW), (const char *)"Cache hits, misses and size of a MEMO function", (crossline_color_e)(CROSSLINE_FGCOLOR_BRIGHT | CROSSLINE_FGCOLOR_GREEN), (const char *)"MEMO_STATS(func)", (crossline_color_e)(CROSSLINE_FGCOLOR_BRIGHT | CROSSLINE_FGCOLOR_GREEN)},
 		{nullptr, CROSSLINE_COLOR_DEFAULT, nullptr, CROSSLINE_COLOR_DEFAULT, nullptr, CROSSLINE_COLOR_DEFAULT}};
 
 	void completion_hook(const char *buf, crossline_completions_t *pCompletion)
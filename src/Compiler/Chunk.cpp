@@ -0,0 +1,196 @@
+#include "Compiler/Chunk.h"
+#include "Common/utils.h"
+
+namespace Basic
+{
+	Chunk::Chunk(const string &name)
+	{
+		this->name = name;
+		this->max_stack = 0;
+	}
+
+	const Position &Chunk::get_pos_start(size_t ip)
+	{
+		return this->spans[this->span_of[ip]].first;
+	}
+
+	const Position &Chunk::get_pos_end(size_t ip)
+	{
+		return this->spans[this->span_of[ip]].second;
+	}
+
+	string Chunk::disassemble()
+	{
+		string result = Basic::format("== %s ==\n", this->name.c_str());
+
+		for (size_t ip = 0; ip < code.size(); ip++)
+		{
+			const Instruction &ins = code[ip];
+			result += Basic::format("%04d  %-14s", (int)ip, opcode_name(ins.op));
+
+			switch (ins.op)
+			{
+			case OpCode::NUMBER:
+				result += Basic::format("%4d '%g'", (int)ins.a, numbers[ins.a]);
+				break;
+			case OpCode::CONSTANT:
+				result += Basic::format("%4d '%s'", (int)ins.a, (*constants[ins.a])->repr().c_str());
+				break;
+			case OpCode::GET_VAR:
+			case OpCode::GET_REF:
+			case OpCode::DEFINE:
+			case OpCode::SET_VAR:
+			case OpCode::DELETE:
+				result += Basic::format("%4d '%s'", (int)ins.a, names[ins.a].c_str());
+				break;
+			case OpCode::GET_LOCAL:
+			case OpCode::GET_LOCAL_REF:
+				result += Basic::format("%4d depth %d", (int)ins.a, (int)ins.b);
+				break;
+			case OpCode::DEFINE_LOCAL:
+			case OpCode::SET_LOCAL:
+			case OpCode::DELETE_LOCAL:
+				result += Basic::format("%4d '%s'", (int)ins.a, local_names[ins.a].c_str());
+				break;
+			case OpCode::ATTR:
+				result += Basic::format("%4d '%s'", (int)ins.a, string(attributes[ins.a].value).c_str());
+				break;
+			case OpCode::MAKE_FUNCTION:
+				result += Basic::format("%4d <function %s>", (int)ins.a, functions[ins.a].name.c_str());
+				break;
+			case OpCode::JUMP:
+			case OpCode::JUMP_IF_FALSE:
+				result += Basic::format("-> %04d", (int)ins.a);
+				break;
+			case OpCode::FOR_LOCAL:
+				result += Basic::format("-> %04d '%s'", (int)ins.a, local_names[ins.b].c_str());
+				break;
+			case OpCode::FOR_VAR:
+				result += Basic::format("-> %04d '%s'", (int)ins.a, names[ins.b].c_str());
+				break;
+			case OpCode::BUILD_LIST:
+				result += Basic::format("%4d%s", (int)ins.a, ins.b ? " (skip null)" : "");
+				break;
+			case OpCode::BUILD_DICT:
+			case OpCode::ACCUMULATE:
+			case OpCode::CALL:
+			case OpCode::TAIL_CALL:
+				result += Basic::format("%4d", (int)ins.a);
+				break;
+			default:
+				break;
+			}
+			result += "\n";
+		}
+
+		for (auto &proto : functions)
+			result += "\n" + proto.chunk->disassemble();
+
+		return result;
+	}
+
+	const char *opcode_name(OpCode op)
+	{
+		switch (op)
+		{
+		case OpCode::NUMBER:
+			return "NUMBER";
+		case OpCode::CONSTANT:
+			return "CONSTANT";
+		case OpCode::NONE:
+			return "NONE";
+		case OpCode::POP:
+			return "POP";
+		case OpCode::GET_VAR:
+			return "GET_VAR";
+		case OpCode::GET_REF:
+			return "GET_REF";
+		case OpCode::GET_LOCAL:
+			return "GET_LOCAL";
+		case OpCode::GET_LOCAL_REF:
+			return "GET_LOCAL_REF";
+		case OpCode::DEFINE:
+			return "DEFINE";
+		case OpCode::DEFINE_LOCAL:
+			return "DEFINE_LOCAL";
+		case OpCode::SET_VAR:
+			return "SET_VAR";
+		case OpCode::SET_LOCAL:
+			return "SET_LOCAL";
+		case OpCode::MUTATE:
+			return "MUTATE";
+		case OpCode::DELETE:
+			return "DELETE";
+		case OpCode::DELETE_LOCAL:
+			return "DELETE_LOCAL";
+		case OpCode::BUILD_LIST:
+			return "BUILD_LIST";
+		case OpCode::BUILD_DICT:
+			return "BUILD_DICT";
+		case OpCode::ADD:
+			return "ADD";
+		case OpCode::SUB:
+			return "SUB";
+		case OpCode::MUL:
+			return "MUL";
+		case OpCode::DIV:
+			return "DIV";
+		case OpCode::POW:
+			return "POW";
+		case OpCode::EE:
+			return "EE";
+		case OpCode::NE:
+			return "NE";
+		case OpCode::LT:
+			return "LT";
+		case OpCode::GT:
+			return "GT";
+		case OpCode::LTE:
+			return "LTE";
+		case OpCode::GTE:
+			return "GTE";
+		case OpCode::AND:
+			return "AND";
+		case OpCode::OR:
+			return "OR";
+		case OpCode::NEGATE:
+			return "NEGATE";
+		case OpCode::NOT:
+			return "NOT";
+		case OpCode::INDEX:
+			return "INDEX";
+		case OpCode::ATTR:
+			return "ATTR";
+		case OpCode::JUMP:
+			return "JUMP";
+		case OpCode::JUMP_IF_FALSE:
+			return "JUMP_IF_FALSE";
+		case OpCode::LIST_NEW:
+			return "LIST_NEW";
+		case OpCode::ACCUMULATE:
+			return "ACCUMULATE";
+		case OpCode::LOOP_RESULT:
+			return "LOOP_RESULT";
+		case OpCode::FOR_PREP:
+			return "FOR_PREP";
+		case OpCode::FOR_LOCAL:
+			return "FOR_LOCAL";
+		case OpCode::FOR_VAR:
+			return "FOR_VAR";
+		case OpCode::FOR_END:
+			return "FOR_END";
+		case OpCode::MAKE_FUNCTION:
+			return "MAKE_FUNCTION";
+		case OpCode::CALL:
+			return "CALL";
+		case OpCode::TAIL_CALL:
+			return "TAIL_CALL";
+		case OpCode::RETURN:
+			return "RETURN";
+		case OpCode::HALT:
+			return "HALT";
+		}
+
+		return "UNKNOWN";
+	}
+}
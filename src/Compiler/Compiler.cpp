@@ -0,0 +1,684 @@
+#include "Compiler/Compiler.h"
+#include "Parser/InvalidSyntaxError.h"
+#include "Common/utils.h"
+#include <algorithm>
+#include <cstring>
+
+
+namespace Basic
+{
+	Compiler::Compiler(const vector<map<string, uint32_t>> &scopes)
+	{
+		this->scopes = scopes;
+		this->span_node = nullptr;
+		this->depth = 0;
+	}
+
+	shared_ptr<Chunk> Compiler::compile(ASTNode *root, const string &name)
+	{
+		this->chunk = make_shared<Chunk>(name);
+		this->loops.clear();
+		this->name_index.clear();
+		this->number_index.clear();
+		this->string_index.clear();
+		this->span_node = nullptr;
+		this->depth = 0;
+
+		compile_node(root);
+
+		set_span(root);
+		emit(OpCode::HALT);
+
+		return this->chunk;
+	}
+
+	void Compiler::compile_node(ASTNode *root, bool byRef)
+	{
+		if (typeid(*root) == typeid(NumberNode))
+		{
+			compile_NumberNode(static_cast<NumberNode *>(root));
+		}
+		else if (typeid(*root) == typeid(StringNode))
+		{
+			compile_StringNode(static_cast<StringNode *>(root));
+		}
+		else if (typeid(*root) == typeid(ListNode))
+		{
+			compile_ListNode(static_cast<ListNode *>(root));
+		}
+		else if (typeid(*root) == typeid(DictNode))
+		{
+			compile_DictNode(static_cast<DictNode *>(root));
+		}
+		else if (typeid(*root) == typeid(IndexNode))
+		{
+			compile_IndexNode(static_cast<IndexNode *>(root));
+		}
+		else if (typeid(*root) == typeid(AttrNode))
+		{
+			compile_AttrNode(static_cast<AttrNode *>(root));
+		}
+		else if (typeid(*root) == typeid(BinOpNode))
+		{
+			compile_BinOpNode(static_cast<BinOpNode *>(root));
+		}
+		else if (typeid(*root) == typeid(UnaryOpNode))
+		{
+			compile_UnaryOpNode(static_cast<UnaryOpNode *>(root));
+		}
+		else if (typeid(*root) == typeid(VarAccessNode))
+		{
+			compile_VarAccessNode(static_cast<VarAccessNode *>(root), byRef);
+		}
+		else if (typeid(*root) == typeid(VarReferenceNode))
+		{
+			compile_node(static_cast<VarReferenceNode *>(root)->get_variable(), true);
+		}
+		else if (typeid(*root) == typeid(VarAssignNode))
+		{
+			compile_VarAssignNode(static_cast<VarAssignNode *>(root));
+		}
+		else if (typeid(*root) == typeid(VarDeleteNode))
+		{
+			compile_VarDeleteNode(static_cast<VarDeleteNode *>(root));
+		}
+		else if (typeid(*root) == typeid(DefineNode))
+		{
+			compile_DefineNode(static_cast<DefineNode *>(root));
+		}
+		else if (typeid(*root) == typeid(MutateNode))
+		{
+			compile_MutateNode(static_cast<MutateNode *>(root));
+		}
+		else if (typeid(*root) == typeid(IfNode))
+		{
+			compile_IfNode(static_cast<IfNode *>(root));
+		}
+		else if (typeid(*root) == typeid(ForNode))
+		{
+			compile_ForNode(static_cast<ForNode *>(root));
+		}
+		else if (typeid(*root) == typeid(WhileNode))
+		{
+			compile_WhileNode(static_cast<WhileNode *>(root));
+		}
+		else if (typeid(*root) == typeid(FuncDefNode))
+		{
+			compile_FuncDefNode(static_cast<FuncDefNode *>(root));
+		}
+		else if (typeid(*root) == typeid(CallNode))
+		{
+			compile_CallNode(static_cast<CallNode *>(root));
+		}
+		else if (typeid(*root) == typeid(ReturnNode))
+		{
+			compile_ReturnNode(static_cast<ReturnNode *>(root));
+		}
+		else if (typeid(*root) == typeid(BreakNode))
+		{
+			compile_BreakNode(static_cast<BreakNode *>(root));
+		}
+		else if (typeid(*root) == typeid(ContinueNode))
+		{
+			compile_ContinueNode(static_cast<ContinueNode *>(root));
+		}
+		else
+		{
+			string message = Basic::format("No compile method for %s defined", typeid(*root).name());
+			throw InvalidSyntaxError(root->pos_start, root->pos_end, message);
+		}
+	}
+
+	void Compiler::compile_NumberNode(NumberNode *root)
+	{
+		set_span(root);
+		emit(OpCode::NUMBER, make_number(root->get_tok().get_number()));
+	}
+
+	void Compiler::compile_StringNode(StringNode *root)
+	{
+		set_span(root);
+		emit(OpCode::CONSTANT, make_string(string(root->get_tok().value)));
+	}
+
+	void Compiler::compile_ListNode(ListNode *root)
+	{
+		const ArenaList<ASTNode *> &elements = root->get_element_nodes();
+		if (root->is_return_null())
+		{
+			for (auto const &elem_node : elements)
+			{
+				compile_node(elem_node);
+				set_span(root);
+				emit(OpCode::POP);
+			}
+
+			emit(OpCode::NONE);
+			return;
+		}
+
+		for (auto const &elem_node : elements)
+			compile_node(elem_node);
+
+		set_span(root);
+		emit(OpCode::BUILD_LIST, elements.size(), 1);
+	}
+
+	void Compiler::compile_DictNode(DictNode *root)
+	{
+		vector<string> keys;
+		for (auto const &elem_pair : root->get_elements())
+		{
+			compile_node(elem_pair.second);
+			keys.push_back(string(elem_pair.first));
+		}
+
+		chunk->key_sets.push_back(keys);
+
+		set_span(root);
+		emit(OpCode::BUILD_DICT, chunk->key_sets.size() - 1);
+	}
+
+	void Compiler::compile_BinOpNode(BinOpNode *root)
+	{
+		compile_node(root->get_left());
+		compile_node(root->get_right());
+
+		Token &op = root->get_op();
+		OpCode code;
+
+		if (op.type == TD_PLUS)
+			code = OpCode::ADD;
+		else if (op.type == TD_MINUS)
+			code = OpCode::SUB;
+		else if (op.type == TD_MUL)
+			code = OpCode::MUL;
+		else if (op.type == TD_DIV)
+			code = OpCode::DIV;
+		else if (op.type == TD_POW)
+			code = OpCode::POW;
+		else if (op.type == TD_EE)
+			code = OpCode::EE;
+		else if (op.type == TD_NE)
+			code = OpCode::NE;
+		else if (op.type == TD_LT)
+			code = OpCode::LT;
+		else if (op.type == TD_GT)
+			code = OpCode::GT;
+		else if (op.type == TD_LTE)
+			code = OpCode::LTE;
+		else if (op.type == TD_GTE)
+			code = OpCode::GTE;
+		else if (op.matches(KW_AND))
+			code = OpCode::AND;
+		else if (op.matches(KW_OR))
+			code = OpCode::OR;
+		else
+			throw InvalidSyntaxError(op.pos_start, op.pos_end, "Unknown binary operator " + op.repr());
+
+		set_span(root);
+		emit(code);
+	}
+
+	void Compiler::compile_UnaryOpNode(UnaryOpNode *root)
+	{
+		compile_node(root->get_node());
+
+		set_span(root);
+		if (root->get_op().type == TD_MINUS)
+			emit(OpCode::NEGATE);
+		else if (root->get_op().matches(KW_NOT))
+			emit(OpCode::NOT);
+	}
+
+	void Compiler::compile_VarAccessNode(VarAccessNode *root, bool byRef)
+	{
+		string var_name(root->get_var_name_tok().value);
+		uint32_t slot, depth;
+
+		set_span(root);
+		if (resolve(var_name, slot, depth))
+			emit(byRef ? OpCode::GET_LOCAL_REF : OpCode::GET_LOCAL, slot, depth);
+		else
+			emit(byRef ? OpCode::GET_REF : OpCode::GET_VAR, make_name(var_name));
+	}
+
+	void Compiler::compile_VarDeleteNode(VarDeleteNode *root)
+	{
+		set_span(root);
+		for (auto const &tok : root->get_deletion())
+		{
+			// 只有当前函数自己的局部变量可以通过槽位删除
+			string var_name(tok.value);
+			uint32_t slot, depth;
+			if (resolve(var_name, slot, depth) && depth == 0)
+				emit(OpCode::DELETE_LOCAL, slot);
+			else
+				emit(OpCode::DELETE, make_name(var_name));
+		}
+
+		emit(OpCode::NONE);
+	}
+
+	void Compiler::compile_MutateNode(MutateNode *root)
+	{
+		compile_node(root->get_mutant(), true);
+		compile_node(root->get_value(), true);
+
+		set_span(root);
+		emit(OpCode::MUTATE);
+	}
+
+	void Compiler::compile_DefineNode(DefineNode *root)
+	{
+		compile_node(root->get_value_node());
+
+		string var_name(root->get_var_name_tok().value);
+		uint32_t slot, depth;
+
+		set_span(root);
+		if (resolve(var_name, slot, depth) && depth == 0)
+			emit(OpCode::DEFINE_LOCAL, slot);
+		else
+			emit(OpCode::DEFINE, make_name(var_name));
+	}
+
+	void Compiler::compile_VarAssignNode(VarAssignNode *root)
+	{
+		const ArenaList<ASTNode *> &assignments = root->get_assignments();
+		for (auto const &ptr : assignments)
+			compile_node(ptr);
+
+		if (assignments.size() != 1)
+		{
+			set_span(root);
+			emit(OpCode::BUILD_LIST, assignments.size(), 0);
+		}
+	}
+
+	void Compiler::compile_IndexNode(IndexNode *root)
+	{
+		compile_node(root->get_value(), true);
+		compile_node(root->get_index());
+
+		set_span(root);
+		emit(OpCode::INDEX);
+	}
+
+	void Compiler::compile_AttrNode(AttrNode *root)
+	{
+		compile_node(root->get_elem());
+
+		chunk->attributes.push_back(root->get_attr());
+
+		set_span(root);
+		emit(OpCode::ATTR, chunk->attributes.size() - 1);
+	}
+
+	void Compiler::compile_IfNode(IfNode *root)
+	{
+		vector<size_t> end_jumps;
+
+		for (auto &elem : root->get_cases())
+		{
+			ASTNode *condition_node = elem.condition;
+			ASTNode *expr_node = elem.expr;
+			bool should_return_null = elem.return_null;
+
+			compile_node(condition_node);
+			set_span(root);
+			size_t next_case = emit(OpCode::JUMP_IF_FALSE);
+
+			compile_node(expr_node);
+			set_span(root);
+			if (should_return_null)
+			{
+				emit(OpCode::POP);
+				emit(OpCode::NONE);
+			}
+			end_jumps.push_back(emit(OpCode::JUMP));
+
+			// 下一个分支不会拿到这个分支的值
+			this->depth--;
+			patch_jump(next_case);
+		}
+
+		Else_Case &else_case = root->get_else_case();
+		ASTNode *else_node = else_case.expr;
+		if (else_node != nullptr)
+		{
+			compile_node(else_node);
+			set_span(root);
+			if (else_case.return_null)
+			{
+				emit(OpCode::POP);
+				emit(OpCode::NONE);
+			}
+		}
+		else
+		{
+			set_span(root);
+			emit(OpCode::NONE);
+		}
+
+		for (size_t jump : end_jumps)
+			patch_jump(jump);
+	}
+
+	void Compiler::compile_ForNode(ForNode *root)
+	{
+		// 多行循环不作为表达式，不必收集每次循环的值
+		bool collect = !root->is_return_null();
+		int result_slot = this->depth;
+
+		set_span(root);
+		if (collect)
+			emit(OpCode::LIST_NEW);
+
+		compile_node(root->get_start_value_node());
+		compile_node(root->get_end_value_node());
+
+		ASTNode *step_node = root->get_step_value_node();
+		if (step_node != nullptr)
+			compile_node(step_node);
+
+		set_span(root);
+		emit(OpCode::FOR_PREP, collect, step_node != nullptr);
+
+		// 计数器直接写入循环变量，不经过栈
+		string var_name(root->get_var_name_tok().value);
+		uint32_t slot, depth;
+		size_t loop_start;
+		if (resolve(var_name, slot, depth) && depth == 0)
+			loop_start = emit(OpCode::FOR_LOCAL, 0, slot);
+		else
+			loop_start = emit(OpCode::FOR_VAR, 0, make_name(var_name));
+
+		loops.push_back(LoopInfo{this->depth, loop_start, {}});
+
+		compile_node(root->get_body_node());
+		set_span(root);
+		if (collect)
+			emit(OpCode::ACCUMULATE, result_slot);
+		else
+			emit(OpCode::POP);
+		emit(OpCode::JUMP, loop_start);
+
+		patch_jump(loop_start);
+		for (size_t jump : loops.back().break_jumps)
+			patch_jump(jump);
+		loops.pop_back();
+
+		emit(OpCode::FOR_END);
+		if (collect)
+			emit(OpCode::LOOP_RESULT);
+		else
+			emit(OpCode::NONE);
+	}
+
+	void Compiler::compile_WhileNode(WhileNode *root)
+	{
+		bool collect = !root->is_return_null();
+		int result_slot = this->depth;
+
+		set_span(root);
+		if (collect)
+			emit(OpCode::LIST_NEW);
+
+		size_t loop_start = chunk->code.size();
+		compile_node(root->get_condition_node());
+		set_span(root);
+		size_t exit_jump = emit(OpCode::JUMP_IF_FALSE);
+
+		loops.push_back(LoopInfo{this->depth, loop_start, {}});
+
+		compile_node(root->get_body_node());
+		set_span(root);
+		if (collect)
+			emit(OpCode::ACCUMULATE, result_slot);
+		else
+			emit(OpCode::POP);
+		emit(OpCode::JUMP, loop_start);
+
+		patch_jump(exit_jump);
+		for (size_t jump : loops.back().break_jumps)
+			patch_jump(jump);
+		loops.pop_back();
+
+		if (collect)
+			emit(OpCode::LOOP_RESULT);
+		else
+			emit(OpCode::NONE);
+	}
+
+	void Compiler::compile_FuncDefNode(FuncDefNode *root)
+	{
+		FunctionProto proto;
+		proto.name = string(root->get_var_name_tok().value);
+		proto.auto_return = root->is_auto_return();
+
+		// 为函数体中的局部变量分配槽位
+		Resolver resolver;
+		resolver.resolve(root);
+
+		vector<map<string, uint32_t>> function_scopes = this->scopes;
+		function_scopes.push_back(resolver.get_slots());
+
+		// 函数体单独编译为一段字节码
+		Compiler function_compiler(function_scopes);
+		proto.chunk = function_compiler.compile(root->get_body_node(), proto.name);
+		proto.chunk->local_names = resolver.get_names();
+
+		for (const Token &tok : root->get_arg_name_toks())
+		{
+			string arg_name(tok.value);
+			proto.arg_names.push_back(arg_name);
+			proto.chunk->arg_slots.push_back(resolver.get_slots().at(arg_name));
+		}
+
+		chunk->functions.push_back(proto);
+
+		set_span(root);
+		emit(OpCode::MAKE_FUNCTION, chunk->functions.size() - 1);
+
+		if (!root->isAnonymous())
+		{
+			uint32_t slot, depth;
+			if (resolve(proto.name, slot, depth) && depth == 0)
+				emit(OpCode::SET_LOCAL, slot);
+			else
+				emit(OpCode::SET_VAR, make_name(proto.name));
+		}
+	}
+
+	void Compiler::compile_CallNode(CallNode *root)
+	{
+		compile_node(root->get_func_node());
+
+		const ArenaList<ASTNode *> &args = root->get_args_nodes();
+		for (auto const &arg_node : args)
+			compile_node(arg_node);
+
+		set_span(root);
+		emit(root->is_tail() ? OpCode::TAIL_CALL : OpCode::CALL, args.size());
+	}
+
+	void Compiler::compile_ReturnNode(ReturnNode *root)
+	{
+		ASTNode *return_node = root->get_return_node();
+		if (return_node != nullptr)
+			compile_node(return_node);
+		else
+		{
+			set_span(root);
+			emit(OpCode::NONE);
+		}
+
+		set_span(root);
+		emit(OpCode::RETURN);
+	}
+
+	void Compiler::compile_BreakNode(BreakNode *root)
+	{
+		if (loops.empty())
+			throw InvalidSyntaxError(root->pos_start, root->pos_end, "'BREAK' outside of a loop");
+
+		// 跳转之后的代码不可达，但为保持栈深度一致，视作该语句产生了一个值
+		int saved_depth = this->depth;
+
+		set_span(root);
+		pop_to(loops.back().depth);
+		loops.back().break_jumps.push_back(emit(OpCode::JUMP));
+
+		this->depth = saved_depth + 1;
+	}
+
+	void Compiler::compile_ContinueNode(ContinueNode *root)
+	{
+		if (loops.empty())
+			throw InvalidSyntaxError(root->pos_start, root->pos_end, "'CONTINUE' outside of a loop");
+
+		int saved_depth = this->depth;
+
+		set_span(root);
+		pop_to(loops.back().depth);
+		emit(OpCode::JUMP, loops.back().continue_target);
+
+		this->depth = saved_depth + 1;
+	}
+
+	size_t Compiler::emit(OpCode op, uint32_t a, uint32_t b)
+	{
+		chunk->code.push_back(Instruction{op, a, b});
+		chunk->span_of.push_back(chunk->spans.size() - 1);
+
+		switch (op)
+		{
+		case OpCode::NUMBER:
+		case OpCode::CONSTANT:
+		case OpCode::NONE:
+		case OpCode::GET_VAR:
+		case OpCode::GET_REF:
+		case OpCode::GET_LOCAL:
+		case OpCode::GET_LOCAL_REF:
+		case OpCode::LIST_NEW:
+		case OpCode::MAKE_FUNCTION:
+			this->depth++;
+			break;
+		case OpCode::POP:
+		case OpCode::MUTATE:
+		case OpCode::ADD:
+		case OpCode::SUB:
+		case OpCode::MUL:
+		case OpCode::DIV:
+		case OpCode::POW:
+		case OpCode::EE:
+		case OpCode::NE:
+		case OpCode::LT:
+		case OpCode::GT:
+		case OpCode::LTE:
+		case OpCode::GTE:
+		case OpCode::AND:
+		case OpCode::OR:
+		case OpCode::INDEX:
+		case OpCode::JUMP_IF_FALSE:
+		case OpCode::ACCUMULATE:
+		case OpCode::HALT:
+			this->depth--;
+			break;
+		case OpCode::BUILD_LIST:
+			this->depth += 1 - (int)a;
+			break;
+		case OpCode::BUILD_DICT:
+			this->depth += 1 - (int)chunk->key_sets[a].size();
+			break;
+		case OpCode::FOR_PREP:
+			this->depth -= 2 + (int)b;
+			break;
+		case OpCode::CALL:
+		case OpCode::TAIL_CALL:
+			this->depth -= (int)a;
+			break;
+		default:
+			// RETURN之后的代码不可达，与BREAK相同，视作值仍在栈上
+			break;
+		}
+
+		chunk->max_stack = std::max(chunk->max_stack, this->depth);
+
+		return chunk->code.size() - 1;
+	}
+
+	void Compiler::patch_jump(size_t at)
+	{
+		chunk->code[at].a = chunk->code.size();
+	}
+
+	void Compiler::pop_to(int depth)
+	{
+		while (this->depth > depth)
+			emit(OpCode::POP);
+	}
+
+	void Compiler::set_span(ASTNode *node)
+	{
+		if (node == span_node && !chunk->spans.empty())
+			return;
+
+		span_node = node;
+		chunk->spans.push_back(std::make_pair(node->pos_start, node->pos_end));
+	}
+
+	uint32_t Compiler::make_number(double value)
+	{
+		// 按位比较，0与-0各占一项
+		uint64_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+
+		auto result = number_index.find(bits);
+		if (result != number_index.end())
+			return result->second;
+
+		chunk->numbers.push_back(value);
+		number_index[bits] = chunk->numbers.size() - 1;
+		return chunk->numbers.size() - 1;
+	}
+
+	uint32_t Compiler::make_string(const string &text)
+	{
+		auto result = string_index.find(text);
+		if (result != string_index.end())
+			return result->second;
+
+		chunk->constants.push_back(make_Dataptr<String>(text));
+		string_index[text] = chunk->constants.size() - 1;
+		return chunk->constants.size() - 1;
+	}
+
+	uint32_t Compiler::make_name(const string &name)
+	{
+		auto result = name_index.find(name);
+		if (result != name_index.end())
+			return result->second;
+
+		chunk->names.push_back(name);
+		name_index[name] = chunk->names.size() - 1;
+		return chunk->names.size() - 1;
+	}
+
+	bool Compiler::resolve(const string &name, uint32_t &slot, uint32_t &depth)
+	{
+		for (size_t i = scopes.size(); i > 0; i--)
+		{
+			auto result = scopes[i - 1].find(name);
+			if (result != scopes[i - 1].end())
+			{
+				slot = result->second;
+				depth = scopes.size() - i;
+				return true;
+			}
+		}
+
+		return false;
+	}
+}
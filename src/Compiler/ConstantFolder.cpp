@@ -0,0 +1,239 @@
+#include "Compiler/ConstantFolder.h"
+#include <cmath>
+
+namespace Basic
+{
+	// 与Number中对应运算的结果一致，无法在此处计算时返回false
+	static bool fold_numbers(const Token &op, double left, double right, double &result)
+	{
+		if (op.type == TD_PLUS)
+			result = left + right;
+		else if (op.type == TD_MINUS)
+			result = left - right;
+		else if (op.type == TD_MUL)
+			result = left * right;
+		else if (op.type == TD_DIV)
+		{
+			// 保留到运行时报错
+			if (right == 0)
+				return false;
+			result = left / right;
+		}
+		else if (op.type == TD_POW)
+			result = pow(left, right);
+		else if (op.type == TD_EE)
+			result = left == right;
+		else if (op.type == TD_NE)
+			result = left != right;
+		else if (op.type == TD_LT)
+			result = left < right;
+		else if (op.type == TD_GT)
+			result = left > right;
+		else if (op.type == TD_LTE)
+			result = left <= right;
+		else if (op.type == TD_GTE)
+			result = left >= right;
+		else if (op.matches(KW_AND))
+			result = (int)left & (int)right;
+		else if (op.matches(KW_OR))
+			result = (int)left | (int)right;
+		else
+			return false;
+
+		return true;
+	}
+
+	ConstantFolder::ConstantFolder(const shared_ptr<AstArena> &arena, bool use_pool)
+	{
+		this->arena = arena;
+		if (use_pool)
+		{
+			this->pool = make_shared<deque<DataPtr>>();
+			this->arena->keep(this->pool);
+		}
+	}
+
+	ASTNode *ConstantFolder::fold(ASTNode *root)
+	{
+		visit(root);
+		return root;
+	}
+
+	void ConstantFolder::visit(ASTNode *&root)
+	{
+		if (root == nullptr)
+			return;
+
+		if (typeid(*root) == typeid(NumberNode) || typeid(*root) == typeid(StringNode))
+		{
+			materialize(root);
+		}
+		else if (typeid(*root) == typeid(ListNode))
+		{
+			for (auto &elem_node : static_cast<ListNode *>(root)->get_element_nodes())
+				visit(elem_node);
+		}
+		else if (typeid(*root) == typeid(DictNode))
+		{
+			for (auto &elem_pair : static_cast<DictNode *>(root)->get_elements())
+				visit(elem_pair.second);
+		}
+		else if (typeid(*root) == typeid(IndexNode))
+		{
+			auto node = static_cast<IndexNode *>(root);
+			visit(node->get_value());
+			visit(node->get_index());
+		}
+		else if (typeid(*root) == typeid(AttrNode))
+		{
+			visit(static_cast<AttrNode *>(root)->get_elem());
+		}
+		else if (typeid(*root) == typeid(BinOpNode))
+		{
+			auto node = static_cast<BinOpNode *>(root);
+			visit(node->get_left());
+			visit(node->get_right());
+			root = fold_BinOpNode(node);
+		}
+		else if (typeid(*root) == typeid(UnaryOpNode))
+		{
+			auto node = static_cast<UnaryOpNode *>(root);
+			visit(node->get_node());
+			root = fold_UnaryOpNode(node);
+		}
+		else if (typeid(*root) == typeid(VarReferenceNode))
+		{
+			visit(static_cast<VarReferenceNode *>(root)->get_variable());
+		}
+		else if (typeid(*root) == typeid(MutateNode))
+		{
+			auto node = static_cast<MutateNode *>(root);
+			visit(node->get_mutant());
+			visit(node->get_value());
+		}
+		else if (typeid(*root) == typeid(DefineNode))
+		{
+			visit(static_cast<DefineNode *>(root)->get_value_node());
+		}
+		else if (typeid(*root) == typeid(VarAssignNode))
+		{
+			for (auto &assignment : static_cast<VarAssignNode *>(root)->get_assignments())
+				visit(assignment);
+		}
+		else if (typeid(*root) == typeid(IfNode))
+		{
+			auto node = static_cast<IfNode *>(root);
+			for (If_Case &if_case : node->get_cases())
+			{
+				visit(if_case.condition);
+				visit(if_case.expr);
+			}
+			visit(node->get_else_case().expr);
+		}
+		else if (typeid(*root) == typeid(ForNode))
+		{
+			auto node = static_cast<ForNode *>(root);
+			visit(node->get_start_value_node());
+			visit(node->get_end_value_node());
+			visit(node->get_step_value_node());
+			visit(node->get_body_node());
+		}
+		else if (typeid(*root) == typeid(WhileNode))
+		{
+			auto node = static_cast<WhileNode *>(root);
+			visit(node->get_condition_node());
+			visit(node->get_body_node());
+		}
+		else if (typeid(*root) == typeid(FuncDefNode))
+		{
+			visit(static_cast<FuncDefNode *>(root)->get_body_node());
+		}
+		else if (typeid(*root) == typeid(CallNode))
+		{
+			auto node = static_cast<CallNode *>(root);
+			visit(node->get_func_node());
+			for (auto &arg_node : node->get_args_nodes())
+				visit(arg_node);
+		}
+		else if (typeid(*root) == typeid(ReturnNode))
+		{
+			visit(static_cast<ReturnNode *>(root)->get_return_node());
+		}
+	}
+
+	ASTNode *ConstantFolder::fold_BinOpNode(BinOpNode *root)
+	{
+		ASTNode *left = root->get_left();
+		ASTNode *right = root->get_right();
+
+		if (typeid(*left) == typeid(NumberNode) && typeid(*right) == typeid(NumberNode))
+		{
+			double result;
+			double left_value = static_cast<NumberNode *>(left)->get_tok().get_number();
+			double right_value = static_cast<NumberNode *>(right)->get_tok().get_number();
+			if (fold_numbers(root->get_op(), left_value, right_value, result))
+				return make_number(result, root->pos_start, root->pos_end);
+		}
+		else if (typeid(*left) == typeid(StringNode) && typeid(*right) == typeid(StringNode) && root->get_op().type == TD_PLUS)
+		{
+			string_view left_value = static_cast<StringNode *>(left)->get_tok().value;
+			string_view right_value = static_cast<StringNode *>(right)->get_tok().value;
+			return make_string(string(left_value) + string(right_value), root->pos_start, root->pos_end);
+		}
+
+		return root;
+	}
+
+	ASTNode *ConstantFolder::fold_UnaryOpNode(UnaryOpNode *root)
+	{
+		ASTNode *node = root->get_node();
+		if (typeid(*node) != typeid(NumberNode))
+			return root;
+
+		double value = static_cast<NumberNode *>(node)->get_tok().get_number();
+		if (root->get_op().type == TD_MINUS)
+			value = value * -1;
+		else if (root->get_op().matches(KW_NOT))
+			value = value == 0 ? 1 : 0;
+
+		return make_number(value, root->pos_start, root->pos_end);
+	}
+
+	ASTNode *ConstantFolder::make_number(double value, const Position &start, const Position &end)
+	{
+		TokenType type = (int)value == value ? TD_INT : TD_FLOAT;
+		ASTNode *node = arena->make<NumberNode>(Token(type, value, start, end));
+		materialize(node);
+		return node;
+	}
+
+	ASTNode *ConstantFolder::make_string(string value, const Position &start, const Position &end)
+	{
+		// 折叠出的文本随语法树一同释放，交互模式下不会一直累积
+		shared_ptr<string> text = make_shared<string>(std::move(value));
+		arena->keep(text);
+		ASTNode *node = arena->make<StringNode>(Token(TD_STRING, string_view(*text), start, end));
+		materialize(node);
+		return node;
+	}
+
+	void ConstantFolder::materialize(ASTNode *root)
+	{
+		if (pool == nullptr)
+			return;
+
+		if (typeid(*root) == typeid(NumberNode))
+		{
+			auto node = static_cast<NumberNode *>(root);
+			pool->push_back(make_Dataptr<Number>(node->get_tok().get_number(), node->pos_start, node->pos_end));
+			node->set_constant(&pool->back());
+		}
+		else
+		{
+			auto node = static_cast<StringNode *>(root);
+			pool->push_back(make_Dataptr<String>(string(node->get_tok().value)));
+			(*pool->back())->set_pos(node->pos_start, node->pos_end);
+			node->set_constant(&pool->back());
+		}
+	}
+}
@@ -0,0 +1,137 @@
+#include "Compiler/Resolver.h"
+
+
+namespace Basic
+{
+	void Resolver::resolve(FuncDefNode *root)
+	{
+		this->slots.clear();
+		this->names.clear();
+
+		// 参数总是占据前几个槽位
+		for (const Token &tok : root->get_arg_name_toks())
+			declare(tok.value);
+
+		visit(root->get_body_node());
+	}
+
+	const map<string, uint32_t> &Resolver::get_slots()
+	{
+		return this->slots;
+	}
+
+	const vector<string> &Resolver::get_names()
+	{
+		return this->names;
+	}
+
+	void Resolver::visit(ASTNode *root)
+	{
+		if (root == nullptr)
+			return;
+
+		if (typeid(*root) == typeid(ListNode))
+		{
+			for (auto const &elem_node : static_cast<ListNode *>(root)->get_element_nodes())
+				visit(elem_node);
+		}
+		else if (typeid(*root) == typeid(DictNode))
+		{
+			for (auto const &elem_pair : static_cast<DictNode *>(root)->get_elements())
+				visit(elem_pair.second);
+		}
+		else if (typeid(*root) == typeid(IndexNode))
+		{
+			auto node = static_cast<IndexNode *>(root);
+			visit(node->get_value());
+			visit(node->get_index());
+		}
+		else if (typeid(*root) == typeid(AttrNode))
+		{
+			visit(static_cast<AttrNode *>(root)->get_elem());
+		}
+		else if (typeid(*root) == typeid(BinOpNode))
+		{
+			auto node = static_cast<BinOpNode *>(root);
+			visit(node->get_left());
+			visit(node->get_right());
+		}
+		else if (typeid(*root) == typeid(UnaryOpNode))
+		{
+			visit(static_cast<UnaryOpNode *>(root)->get_node());
+		}
+		else if (typeid(*root) == typeid(VarReferenceNode))
+		{
+			visit(static_cast<VarReferenceNode *>(root)->get_variable());
+		}
+		else if (typeid(*root) == typeid(MutateNode))
+		{
+			auto node = static_cast<MutateNode *>(root);
+			visit(node->get_mutant());
+			visit(node->get_value());
+		}
+		else if (typeid(*root) == typeid(DefineNode))
+		{
+			auto node = static_cast<DefineNode *>(root);
+			declare(node->get_var_name_tok().value);
+			visit(node->get_value_node());
+		}
+		else if (typeid(*root) == typeid(VarAssignNode))
+		{
+			for (auto const &ptr : static_cast<VarAssignNode *>(root)->get_assignments())
+				visit(ptr);
+		}
+		else if (typeid(*root) == typeid(IfNode))
+		{
+			auto node = static_cast<IfNode *>(root);
+			for (auto &elem : node->get_cases())
+			{
+				visit(elem.condition);
+				visit(elem.expr);
+			}
+			visit(node->get_else_case().expr);
+		}
+		else if (typeid(*root) == typeid(ForNode))
+		{
+			auto node = static_cast<ForNode *>(root);
+			declare(node->get_var_name_tok().value);
+			visit(node->get_start_value_node());
+			visit(node->get_end_value_node());
+			visit(node->get_step_value_node());
+			visit(node->get_body_node());
+		}
+		else if (typeid(*root) == typeid(WhileNode))
+		{
+			auto node = static_cast<WhileNode *>(root);
+			visit(node->get_condition_node());
+			visit(node->get_body_node());
+		}
+		else if (typeid(*root) == typeid(FuncDefNode))
+		{
+			auto node = static_cast<FuncDefNode *>(root);
+			if (!node->isAnonymous())
+				declare(node->get_var_name_tok().value);
+		}
+		else if (typeid(*root) == typeid(CallNode))
+		{
+			auto node = static_cast<CallNode *>(root);
+			visit(node->get_func_node());
+			for (auto const &arg_node : node->get_args_nodes())
+				visit(arg_node);
+		}
+		else if (typeid(*root) == typeid(ReturnNode))
+		{
+			visit(static_cast<ReturnNode *>(root)->get_return_node());
+		}
+	}
+
+	void Resolver::declare(string_view name)
+	{
+		string key(name);
+		if (slots.find(key) != slots.end())
+			return;
+
+		slots[key] = names.size();
+		names.push_back(key);
+	}
+}
@@ -0,0 +1,117 @@
+#include "Compiler/ResultElider.h"
+
+namespace Basic
+{
+	void ResultElider::elide(ASTNode *root, bool used)
+	{
+		visit(root, used);
+	}
+
+	void ResultElider::visit(ASTNode *root, bool used)
+	{
+		if (root == nullptr)
+			return;
+
+		if (typeid(*root) == typeid(ListNode))
+		{
+			auto node = static_cast<ListNode *>(root);
+			if (!used)
+				node->set_return_null(true);
+			for (auto const &elem_node : node->get_element_nodes())
+				visit(elem_node, used);
+		}
+		else if (typeid(*root) == typeid(DictNode))
+		{
+			for (auto const &elem_pair : static_cast<DictNode *>(root)->get_elements())
+				visit(elem_pair.second, used);
+		}
+		else if (typeid(*root) == typeid(IndexNode))
+		{
+			auto node = static_cast<IndexNode *>(root);
+			visit(node->get_value(), true);
+			visit(node->get_index(), true);
+		}
+		else if (typeid(*root) == typeid(AttrNode))
+		{
+			visit(static_cast<AttrNode *>(root)->get_elem(), true);
+		}
+		else if (typeid(*root) == typeid(BinOpNode))
+		{
+			auto node = static_cast<BinOpNode *>(root);
+			visit(node->get_left(), true);
+			visit(node->get_right(), true);
+		}
+		else if (typeid(*root) == typeid(UnaryOpNode))
+		{
+			visit(static_cast<UnaryOpNode *>(root)->get_node(), true);
+		}
+		else if (typeid(*root) == typeid(VarReferenceNode))
+		{
+			visit(static_cast<VarReferenceNode *>(root)->get_variable(), true);
+		}
+		else if (typeid(*root) == typeid(MutateNode))
+		{
+			auto node = static_cast<MutateNode *>(root);
+			visit(node->get_mutant(), true);
+			visit(node->get_value(), true);
+		}
+		else if (typeid(*root) == typeid(DefineNode))
+		{
+			visit(static_cast<DefineNode *>(root)->get_value_node(), true);
+		}
+		else if (typeid(*root) == typeid(VarAssignNode))
+		{
+			for (auto const &assignment : static_cast<VarAssignNode *>(root)->get_assignments())
+				visit(assignment, true);
+		}
+		else if (typeid(*root) == typeid(IfNode))
+		{
+			// 条件总会被判断；分支的值只在单行IF且IF本身的值被使用时才有意义
+			auto node = static_cast<IfNode *>(root);
+			for (If_Case &if_case : node->get_cases())
+			{
+				visit(if_case.condition, true);
+				visit(if_case.expr, used && !if_case.return_null);
+			}
+
+			Else_Case &else_case = node->get_else_case();
+			visit(else_case.expr, used && !else_case.return_null);
+		}
+		else if (typeid(*root) == typeid(ForNode))
+		{
+			auto node = static_cast<ForNode *>(root);
+			if (!used)
+				node->set_return_null(true);
+
+			visit(node->get_start_value_node(), true);
+			visit(node->get_end_value_node(), true);
+			visit(node->get_step_value_node(), true);
+			visit(node->get_body_node(), !node->is_return_null());
+		}
+		else if (typeid(*root) == typeid(WhileNode))
+		{
+			auto node = static_cast<WhileNode *>(root);
+			if (!used)
+				node->set_return_null(true);
+
+			visit(node->get_condition_node(), true);
+			visit(node->get_body_node(), !node->is_return_null());
+		}
+		else if (typeid(*root) == typeid(FuncDefNode))
+		{
+			auto node = static_cast<FuncDefNode *>(root);
+			visit(node->get_body_node(), node->is_auto_return());
+		}
+		else if (typeid(*root) == typeid(CallNode))
+		{
+			auto node = static_cast<CallNode *>(root);
+			visit(node->get_func_node(), true);
+			for (auto const &arg_node : node->get_args_nodes())
+				visit(arg_node, true);
+		}
+		else if (typeid(*root) == typeid(ReturnNode))
+		{
+			visit(static_cast<ReturnNode *>(root)->get_return_node(), true);
+		}
+	}
+}
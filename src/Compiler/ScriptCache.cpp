@@ -0,0 +1,133 @@
+#include "Compiler/ScriptCache.h"
+#include "Compiler/Serializer.h"
+#include "Common/MappedFile.h"
+#include <filesystem>
+#include <fstream>
+#include <cstdio>
+
+namespace fs = std::filesystem;
+
+namespace Basic
+{
+	bool ScriptCache::stat(const string &path, Stamp &stamp)
+	{
+		std::error_code ec;
+		fs::file_time_type mtime = fs::last_write_time(path, ec);
+		if (ec)
+			return false;
+
+		uintmax_t size = fs::file_size(path, ec);
+		if (ec)
+			return false;
+
+		stamp.mtime = mtime.time_since_epoch().count();
+		stamp.size = size;
+		return true;
+	}
+
+	bool ScriptCache::find(const string &path, const Stamp &stamp, Program &program)
+	{
+		auto it = entries().find(path);
+		if (it == entries().end() || !(it->second.stamp == stamp))
+			return false;
+
+		program = it->second.program;
+		return true;
+	}
+
+	bool ScriptCache::find(const string &path, const Stamp &stamp, uint64_t hash, Program &program)
+	{
+		auto it = entries().find(path);
+		if (it == entries().end() || it->second.hash != hash)
+			return false;
+
+		it->second.stamp = stamp;
+		program = it->second.program;
+		return true;
+	}
+
+	void ScriptCache::store(const string &path, const Stamp &stamp, uint64_t hash, const Program &program)
+	{
+		entries()[path] = Entry{stamp, hash, program};
+	}
+
+	void ScriptCache::set_disk_dir(const string &dir)
+	{
+		disk_dir() = dir;
+	}
+
+	shared_ptr<Chunk> ScriptCache::load_disk(const string &path, uint64_t hash)
+	{
+		if (disk_dir().empty())
+			return nullptr;
+
+		MappedFile file;
+		if (!file.open(disk_path(path)))
+			return nullptr;
+
+		uint64_t source_hash;
+		shared_ptr<Chunk> chunk = Serializer::load(file.data(), source_hash);
+		if (chunk == nullptr || source_hash != hash)
+			return nullptr;
+
+		return chunk;
+	}
+
+	void ScriptCache::save_disk(const string &path, uint64_t hash, const string &source, const Chunk &chunk)
+	{
+		if (disk_dir().empty())
+			return;
+
+		string data;
+		if (!Serializer::save(chunk, path, source, hash, data))
+			return;
+
+		std::error_code ec;
+		fs::create_directories(disk_dir(), ec);
+
+		// 先写临时文件再改名，避免其他进程读到写了一半的文件
+		string target = disk_path(path);
+		string temp = target + ".tmp";
+		{
+			std::ofstream ofs(temp, std::ios::binary | std::ios::trunc);
+			if (!ofs)
+				return;
+			ofs.write(data.data(), data.size());
+			if (!ofs)
+				return;
+		}
+
+		fs::rename(temp, target, ec);
+		if (ec)
+			fs::remove(temp, ec);
+	}
+
+	uint64_t ScriptCache::hash(string_view text)
+	{
+		return Serializer::checksum(text);
+	}
+
+	string ScriptCache::disk_path(const string &path)
+	{
+		// 以绝对路径的哈希命名，不同目录下的同名脚本互不干扰
+		std::error_code ec;
+		fs::path absolute = fs::absolute(path, ec);
+		string key = ec ? path : absolute.lexically_normal().string();
+
+		char name[32];
+		std::snprintf(name, sizeof(name), "%016llx.bbc", (unsigned long long)hash(key));
+		return (fs::path(disk_dir()) / name).string();
+	}
+
+	unordered_map<string, ScriptCache::Entry> &ScriptCache::entries()
+	{
+		static unordered_map<string, Entry> entries;
+		return entries;
+	}
+
+	string &ScriptCache::disk_dir()
+	{
+		static string dir;
+		return dir;
+	}
+}
@@ -0,0 +1,569 @@
+#include "Compiler/Serializer.h"
+#include <cstring>
+#include <stdexcept>
+#include <optional>
+
+namespace Basic
+{
+	static const char MAGIC[4] = {'B', 'S', 'C', 'B'};
+
+	namespace
+	{
+		class Writer
+		{
+		public:
+			explicit Writer(string &out) : out(out) {}
+
+			template <class T>
+			void raw(T value)
+			{
+				out.append(reinterpret_cast<const char *>(&value), sizeof(T));
+			}
+
+			void str(string_view s)
+			{
+				raw<uint32_t>(s.size());
+				out.append(s.data(), s.size());
+			}
+
+			void pos(const Position &p)
+			{
+				raw<int32_t>(p.index);
+				raw<int32_t>(p.row);
+				raw<int32_t>(p.column);
+			}
+
+			bool chunk(const Chunk &ch)
+			{
+				str(ch.name);
+
+				raw<uint32_t>(ch.code.size());
+				for (const Instruction &ins : ch.code)
+				{
+					raw<uint8_t>(static_cast<uint8_t>(ins.op));
+					raw<uint32_t>(ins.a);
+					raw<uint32_t>(ins.b);
+				}
+
+				raw<uint32_t>(ch.span_of.size());
+				for (uint32_t span : ch.span_of)
+					raw<uint32_t>(span);
+
+				raw<uint32_t>(ch.spans.size());
+				for (auto &span : ch.spans)
+				{
+					pos(span.first);
+					pos(span.second);
+				}
+
+				raw<uint32_t>(ch.numbers.size());
+				for (double number : ch.numbers)
+					raw<double>(number);
+
+				raw<uint32_t>(ch.constants.size());
+				for (const DataPtr &constant : ch.constants)
+				{
+					if (typeid(**constant) != typeid(String))
+						return false;
+					str(raw_Dataptr<String>(constant)->getValue());
+				}
+
+				raw<uint32_t>(ch.names.size());
+				for (const string &name : ch.names)
+					str(name);
+
+				raw<uint32_t>(ch.key_sets.size());
+				for (auto &keys : ch.key_sets)
+				{
+					raw<uint32_t>(keys.size());
+					for (const string &key : keys)
+						str(key);
+				}
+
+				raw<uint32_t>(ch.attributes.size());
+				for (const Token &attr : ch.attributes)
+				{
+					str(attr.value);
+					pos(attr.pos_start);
+					pos(attr.pos_end);
+				}
+
+				raw<uint32_t>(ch.functions.size());
+				for (const FunctionProto &proto : ch.functions)
+				{
+					str(proto.name);
+					raw<uint32_t>(proto.arg_names.size());
+					for (const string &arg : proto.arg_names)
+						str(arg);
+					raw<uint8_t>(proto.auto_return);
+					if (!chunk(*proto.chunk))
+						return false;
+				}
+
+				raw<uint32_t>(ch.local_names.size());
+				for (const string &name : ch.local_names)
+					str(name);
+
+				raw<uint32_t>(ch.arg_slots.size());
+				for (uint32_t slot : ch.arg_slots)
+					raw<uint32_t>(slot);
+
+				raw<int32_t>(ch.max_stack);
+				return true;
+			}
+
+		private:
+			string &out;
+		};
+
+		// 读取越界时抛出std::out_of_range，由Serializer::load统一处理
+		class Reader
+		{
+		public:
+			explicit Reader(string_view data) : data(data), file_id(0) {}
+
+			// 之后读取的Position都属于该源码
+			void set_file_id(uint32_t id)
+			{
+				file_id = id;
+			}
+
+			template <class T>
+			T raw()
+			{
+				T value;
+				std::memcpy(&value, take(sizeof(T)), sizeof(T));
+				return value;
+			}
+
+			string_view str()
+			{
+				uint32_t length = raw<uint32_t>();
+				return string_view(take(length), length);
+			}
+
+			Position pos()
+			{
+				int32_t index = raw<int32_t>();
+				int32_t row = raw<int32_t>();
+				int32_t column = raw<int32_t>();
+				return Position(index, row, column, file_id);
+			}
+
+			// 每个元素至少占一个字节，借此拒绝损坏数据中过大的长度
+			uint32_t count()
+			{
+				uint32_t n = raw<uint32_t>();
+				if (n > data.size())
+					throw std::out_of_range("count");
+				return n;
+			}
+
+			shared_ptr<Chunk> chunk()
+			{
+				shared_ptr<Chunk> ch = std::make_shared<Chunk>(string(str()));
+
+				ch->code.resize(count());
+				for (Instruction &ins : ch->code)
+				{
+					uint8_t op = raw<uint8_t>();
+					if (op > static_cast<uint8_t>(OpCode::HALT))
+						throw std::out_of_range("opcode");
+					ins.op = static_cast<OpCode>(op);
+					ins.a = raw<uint32_t>();
+					ins.b = raw<uint32_t>();
+				}
+
+				ch->span_of.resize(count());
+				for (uint32_t &span : ch->span_of)
+					span = raw<uint32_t>();
+
+				ch->spans.resize(count());
+				for (auto &span : ch->spans)
+				{
+					span.first = pos();
+					span.second = pos();
+				}
+
+				ch->numbers.resize(count());
+				for (double &number : ch->numbers)
+					number = raw<double>();
+
+				ch->constants.resize(count());
+				for (DataPtr &constant : ch->constants)
+					constant = make_Dataptr<String>(string(str()));
+
+				ch->names.resize(count());
+				for (string &name : ch->names)
+					name = string(str());
+
+				ch->key_sets.resize(count());
+				for (auto &keys : ch->key_sets)
+				{
+					keys.resize(count());
+					for (string &key : keys)
+						key = string(str());
+				}
+
+				ch->attributes.resize(count());
+				for (Token &attr : ch->attributes)
+				{
+					string_view value = SourceRegistry::keep(string(str()));
+					Position start = pos();
+					Position end = pos();
+					attr = Token(TD_IDENTIFIER, value, start, end);
+				}
+
+				ch->functions.resize(count());
+				for (FunctionProto &proto : ch->functions)
+				{
+					proto.name = string(str());
+					proto.arg_names.resize(count());
+					for (string &arg : proto.arg_names)
+						arg = string(str());
+					proto.auto_return = raw<uint8_t>() != 0;
+					proto.chunk = chunk();
+				}
+
+				ch->local_names.resize(count());
+				for (string &name : ch->local_names)
+					name = string(str());
+
+				ch->arg_slots.resize(count());
+				for (uint32_t &slot : ch->arg_slots)
+					slot = raw<uint32_t>();
+
+				ch->max_stack = raw<int32_t>();
+				return ch;
+			}
+
+			// 栈的状态：各位置上是否为LIST_NEW压入的List，以及进行中的FOR循环数
+			struct StackState
+			{
+				vector<bool> lists;
+				size_t loops = 0;
+
+				bool operator==(const StackState &other) const
+				{
+					return lists == other.lists && loops == other.loops;
+				}
+			};
+
+			// 沿所有可能的执行路径推演栈深度：不能弹出不存在的值，不能超过max_stack，
+			// ACCUMULATE等只能作用于LIST_NEW的List，FOR_END等必须在FOR循环中，汇合处的状态必须一致
+			static void verify_stack(const Chunk &ch)
+			{
+				auto require = [](bool ok)
+				{
+					if (!ok)
+						throw std::out_of_range("stack");
+				};
+
+				vector<std::optional<StackState>> states(ch.code.size());
+				vector<size_t> pending;
+				auto flow = [&](size_t target, const StackState &state)
+				{
+					if (!states[target].has_value())
+					{
+						states[target] = state;
+						pending.push_back(target);
+					}
+					else
+						require(*states[target] == state);
+				};
+
+				flow(0, StackState());
+				while (!pending.empty())
+				{
+					size_t ip = pending.back();
+					pending.pop_back();
+					const Instruction &ins = ch.code[ip];
+					StackState state = *states[ip];
+					vector<bool> &lists = state.lists;
+
+					auto pop = [&](size_t n)
+					{
+						require(lists.size() >= n);
+						lists.resize(lists.size() - n);
+					};
+					auto push = [&](bool is_list)
+					{
+						lists.push_back(is_list);
+						require(lists.size() <= (size_t)ch.max_stack);
+					};
+
+					bool falls_through = true;
+					switch (ins.op)
+					{
+					case OpCode::NUMBER:
+					case OpCode::CONSTANT:
+					case OpCode::NONE:
+					case OpCode::GET_VAR:
+					case OpCode::GET_REF:
+					case OpCode::GET_LOCAL:
+					case OpCode::GET_LOCAL_REF:
+					case OpCode::MAKE_FUNCTION:
+						push(false);
+						break;
+					case OpCode::LIST_NEW:
+						push(true);
+						break;
+					case OpCode::POP:
+						pop(1);
+						break;
+					case OpCode::DEFINE:
+					case OpCode::DEFINE_LOCAL:
+					case OpCode::SET_VAR:
+					case OpCode::SET_LOCAL:
+						require(!lists.empty());
+						break;
+					case OpCode::DELETE:
+					case OpCode::DELETE_LOCAL:
+						break;
+					case OpCode::BUILD_LIST:
+						pop(ins.a);
+						push(false);
+						break;
+					case OpCode::BUILD_DICT:
+						pop(ch.key_sets[ins.a].size());
+						push(false);
+						break;
+					case OpCode::MUTATE:
+					case OpCode::ADD:
+					case OpCode::SUB:
+					case OpCode::MUL:
+					case OpCode::DIV:
+					case OpCode::POW:
+					case OpCode::EE:
+					case OpCode::NE:
+					case OpCode::LT:
+					case OpCode::GT:
+					case OpCode::LTE:
+					case OpCode::GTE:
+					case OpCode::AND:
+					case OpCode::OR:
+					case OpCode::INDEX:
+						pop(2);
+						push(false);
+						break;
+					case OpCode::NEGATE:
+					case OpCode::NOT:
+					case OpCode::ATTR:
+						pop(1);
+						push(false);
+						break;
+					case OpCode::JUMP:
+						flow(ins.a, state);
+						falls_through = false;
+						break;
+					case OpCode::JUMP_IF_FALSE:
+						pop(1);
+						flow(ins.a, state);
+						break;
+					case OpCode::ACCUMULATE:
+						pop(1);
+						require(ins.a < lists.size() && lists[ins.a]);
+						break;
+					case OpCode::LOOP_RESULT:
+						require(!lists.empty() && lists.back());
+						lists.back() = false;
+						break;
+					case OpCode::FOR_PREP:
+						pop(2 + (ins.b ? 1 : 0));
+						require(!ins.a || (!lists.empty() && lists.back()));
+						state.loops++;
+						break;
+					case OpCode::FOR_LOCAL:
+					case OpCode::FOR_VAR:
+						require(state.loops > 0);
+						flow(ins.a, state);
+						break;
+					case OpCode::FOR_END:
+						require(state.loops > 0);
+						state.loops--;
+						break;
+					case OpCode::CALL:
+					case OpCode::TAIL_CALL:
+						pop(ins.a + 1);
+						push(false);
+						break;
+					case OpCode::RETURN:
+					case OpCode::HALT:
+						require(!lists.empty());
+						falls_through = false;
+						break;
+					}
+
+					if (falls_through)
+					{
+						require(ip + 1 < ch.code.size());
+						flow(ip + 1, state);
+					}
+				}
+			}
+
+			// 校验和只能发现意外损坏。虚拟机不检查下标，因此逐条确认操作数都在各表的范围内
+			// enclosing为外层函数的字节码，由内到外，GET_LOCAL据此检查外层的槽位
+			static void validate(const Chunk &ch, vector<const Chunk *> &enclosing)
+			{
+				auto require = [](bool ok)
+				{
+					if (!ok)
+						throw std::out_of_range("operand");
+				};
+
+				size_t code_size = ch.code.size();
+				require(code_size > 0 && (ch.code.back().op == OpCode::RETURN || ch.code.back().op == OpCode::HALT));
+				// 每条指令至多压入一个值
+				require(ch.span_of.size() == code_size && ch.max_stack >= 0 && (size_t)ch.max_stack <= code_size);
+				// 最外层代码没有局部环境
+				require(!enclosing.empty() || (ch.local_names.empty() && ch.arg_slots.empty()));
+				for (uint32_t span : ch.span_of)
+					require(span < ch.spans.size());
+
+				size_t locals = ch.local_names.size();
+				for (const Instruction &ins : ch.code)
+				{
+					switch (ins.op)
+					{
+					case OpCode::NUMBER:
+						require(ins.a < ch.numbers.size());
+						break;
+					case OpCode::CONSTANT:
+						require(ins.a < ch.constants.size());
+						break;
+					case OpCode::GET_VAR:
+					case OpCode::GET_REF:
+					case OpCode::DEFINE:
+					case OpCode::SET_VAR:
+					case OpCode::DELETE:
+						require(ins.a < ch.names.size());
+						break;
+					case OpCode::GET_LOCAL:
+					case OpCode::GET_LOCAL_REF:
+						require(ins.b <= enclosing.size());
+						require(ins.a < (ins.b == 0 ? ch : *enclosing[ins.b - 1]).local_names.size());
+						break;
+					case OpCode::DEFINE_LOCAL:
+					case OpCode::SET_LOCAL:
+					case OpCode::DELETE_LOCAL:
+						require(ins.a < locals);
+						break;
+					case OpCode::BUILD_DICT:
+						require(ins.a < ch.key_sets.size());
+						break;
+					case OpCode::ATTR:
+						require(ins.a < ch.attributes.size());
+						break;
+					case OpCode::JUMP:
+					case OpCode::JUMP_IF_FALSE:
+						require(ins.a < code_size);
+						break;
+					case OpCode::FOR_LOCAL:
+						require(ins.a < code_size && ins.b < locals);
+						break;
+					case OpCode::FOR_VAR:
+						require(ins.a < code_size && ins.b < ch.names.size());
+						break;
+					case OpCode::MAKE_FUNCTION:
+						require(ins.a < ch.functions.size());
+						break;
+					default:
+						break;
+					}
+				}
+
+				for (uint32_t slot : ch.arg_slots)
+					require(slot < locals);
+
+				verify_stack(ch);
+
+				enclosing.insert(enclosing.begin(), &ch);
+				for (const FunctionProto &proto : ch.functions)
+				{
+					require(proto.chunk->arg_slots.size() == proto.arg_names.size());
+					validate(*proto.chunk, enclosing);
+				}
+				enclosing.erase(enclosing.begin());
+			}
+
+		private:
+			const char *take(size_t n)
+			{
+				if (n > data.size())
+					throw std::out_of_range("truncated");
+				const char *p = data.data();
+				data.remove_prefix(n);
+				return p;
+			}
+
+			string_view data;
+			uint32_t file_id;
+		};
+	}
+
+	// 文件头：魔数、版本号、校验和
+	static const size_t HEADER_SIZE = sizeof(MAGIC) + sizeof(uint32_t) + sizeof(uint64_t);
+
+	bool Serializer::save(const Chunk &chunk, const string &source_name, const string &source, uint64_t source_hash, string &out)
+	{
+		out.clear();
+		Writer writer(out);
+
+		out.append(MAGIC, sizeof(MAGIC));
+		writer.raw<uint32_t>(VERSION);
+		writer.raw<uint64_t>(0); // 校验和，写完内容后回填
+		writer.raw<uint64_t>(source_hash);
+		writer.str(source_name);
+		writer.str(source);
+
+		if (!writer.chunk(chunk))
+			return false;
+
+		uint64_t sum = checksum(string_view(out).substr(HEADER_SIZE));
+		std::memcpy(&out[HEADER_SIZE - sizeof(uint64_t)], &sum, sizeof(sum));
+		return true;
+	}
+
+	shared_ptr<Chunk> Serializer::load(string_view data, uint64_t &source_hash)
+	{
+		try
+		{
+			if (data.size() < HEADER_SIZE || std::memcmp(data.data(), MAGIC, sizeof(MAGIC)) != 0)
+				return nullptr;
+
+			Reader reader(data.substr(sizeof(MAGIC)));
+			if (reader.raw<uint32_t>() != VERSION)
+				return nullptr;
+			if (reader.raw<uint64_t>() != checksum(data.substr(HEADER_SIZE)))
+				return nullptr;
+
+			source_hash = reader.raw<uint64_t>();
+			string source_name(reader.str());
+			string source(reader.str());
+
+			// 重新登记源码，Position中的编号指向本进程的登记表
+			reader.set_file_id(SourceRegistry::add(source_name, source));
+			shared_ptr<Chunk> chunk = reader.chunk();
+
+			vector<const Chunk *> enclosing;
+			Reader::validate(*chunk, enclosing);
+			return chunk;
+		}
+		catch (const std::out_of_range &)
+		{
+			return nullptr;
+		}
+	}
+
+	uint64_t Serializer::checksum(string_view data)
+	{
+		uint64_t h = 14695981039346656037ULL;
+		for (unsigned char c : data)
+		{
+			h ^= c;
+			h *= 1099511628211ULL;
+		}
+		return h;
+	}
+}
@@ -0,0 +1,135 @@
+#include "Compiler/TailCallMarker.h"
+
+namespace Basic
+{
+	void TailCallMarker::mark(ASTNode *root)
+	{
+		visit(root, false);
+	}
+
+	void TailCallMarker::tail(ASTNode *node)
+	{
+		if (node == nullptr)
+			return;
+
+		if (typeid(*node) == typeid(CallNode))
+		{
+			static_cast<CallNode *>(node)->set_tail(true);
+		}
+		else if (typeid(*node) == typeid(IfNode))
+		{
+			// 多行分支的值不会返回，其中的调用不在尾部
+			auto if_node = static_cast<IfNode *>(node);
+			for (If_Case &if_case : if_node->get_cases())
+			{
+				if (!if_case.return_null)
+					tail(if_case.expr);
+			}
+
+			Else_Case &else_case = if_node->get_else_case();
+			if (!else_case.return_null)
+				tail(else_case.expr);
+		}
+	}
+
+	void TailCallMarker::visit(ASTNode *root, bool in_function)
+	{
+		if (root == nullptr)
+			return;
+
+		if (typeid(*root) == typeid(ListNode))
+		{
+			for (auto const &elem_node : static_cast<ListNode *>(root)->get_element_nodes())
+				visit(elem_node, in_function);
+		}
+		else if (typeid(*root) == typeid(DictNode))
+		{
+			for (auto const &elem_pair : static_cast<DictNode *>(root)->get_elements())
+				visit(elem_pair.second, in_function);
+		}
+		else if (typeid(*root) == typeid(IndexNode))
+		{
+			auto node = static_cast<IndexNode *>(root);
+			visit(node->get_value(), in_function);
+			visit(node->get_index(), in_function);
+		}
+		else if (typeid(*root) == typeid(AttrNode))
+		{
+			visit(static_cast<AttrNode *>(root)->get_elem(), in_function);
+		}
+		else if (typeid(*root) == typeid(BinOpNode))
+		{
+			auto node = static_cast<BinOpNode *>(root);
+			visit(node->get_left(), in_function);
+			visit(node->get_right(), in_function);
+		}
+		else if (typeid(*root) == typeid(UnaryOpNode))
+		{
+			visit(static_cast<UnaryOpNode *>(root)->get_node(), in_function);
+		}
+		else if (typeid(*root) == typeid(VarReferenceNode))
+		{
+			visit(static_cast<VarReferenceNode *>(root)->get_variable(), in_function);
+		}
+		else if (typeid(*root) == typeid(MutateNode))
+		{
+			auto node = static_cast<MutateNode *>(root);
+			visit(node->get_mutant(), in_function);
+			visit(node->get_value(), in_function);
+		}
+		else if (typeid(*root) == typeid(DefineNode))
+		{
+			visit(static_cast<DefineNode *>(root)->get_value_node(), in_function);
+		}
+		else if (typeid(*root) == typeid(VarAssignNode))
+		{
+			for (auto const &assignment : static_cast<VarAssignNode *>(root)->get_assignments())
+				visit(assignment, in_function);
+		}
+		else if (typeid(*root) == typeid(IfNode))
+		{
+			auto node = static_cast<IfNode *>(root);
+			for (If_Case &if_case : node->get_cases())
+			{
+				visit(if_case.condition, in_function);
+				visit(if_case.expr, in_function);
+			}
+			visit(node->get_else_case().expr, in_function);
+		}
+		else if (typeid(*root) == typeid(ForNode))
+		{
+			auto node = static_cast<ForNode *>(root);
+			visit(node->get_start_value_node(), in_function);
+			visit(node->get_end_value_node(), in_function);
+			visit(node->get_step_value_node(), in_function);
+			visit(node->get_body_node(), in_function);
+		}
+		else if (typeid(*root) == typeid(WhileNode))
+		{
+			auto node = static_cast<WhileNode *>(root);
+			visit(node->get_condition_node(), in_function);
+			visit(node->get_body_node(), in_function);
+		}
+		else if (typeid(*root) == typeid(FuncDefNode))
+		{
+			auto node = static_cast<FuncDefNode *>(root);
+			visit(node->get_body_node(), true);
+			if (node->is_auto_return())
+				tail(node->get_body_node());
+		}
+		else if (typeid(*root) == typeid(CallNode))
+		{
+			auto node = static_cast<CallNode *>(root);
+			visit(node->get_func_node(), in_function);
+			for (auto const &arg_node : node->get_args_nodes())
+				visit(arg_node, in_function);
+		}
+		else if (typeid(*root) == typeid(ReturnNode))
+		{
+			auto node = static_cast<ReturnNode *>(root);
+			visit(node->get_return_node(), in_function);
+			if (in_function)
+				tail(node->get_return_node());
+		}
+	}
+}
@@ -2,6 +2,10 @@
 #include "Interpreter/Data.h"
 #include "Interpreter/Interpreter.h"
 #include "Interpreter/RunTimeError.h"
+#include "Interpreter/MemoCache.h"
+#include "Common/Profiler.h"
+#include "Common/Tracer.h"
+#include "VM/VM.h"
 #include <cmath>
 #include <stdexcept>
 #include <iostream>
@@ -26,12 +30,9 @@ namespace Basic
 		set_context(context);
 	}
 
-	Number::Number(const Number &other)
+	Number::Number(const Number &other) : Data(other)
 	{
-		this->pos_start = other.pos_start;
-		this->pos_end = other.pos_end;
 		this->value = other.value;
-		this->context = other.context;
 	}
 
 	double Number::get_value(bool wantInt)
@@ -42,8 +43,22 @@ namespace Basic
 		return this->value;
 	}
 
+	void Number::set_value(double value)
+	{
+		this->value = value;
+	}
+
+	void Number::assign(DataPtr &cell, double value)
+	{
+		if (cell != nullptr && cell.use_count() == 1 && typeid(**cell) == typeid(Number))
+			raw_Dataptr<Number>(cell)->value = value;
+		else
+			cell = make_Dataptr<Number>(value);
+	}
+
 	DataPtr Number::clone()
 	{
+		Stats::cloned();
 		return make_Dataptr<Number>(*this);
 	}
 
@@ -327,19 +342,17 @@ namespace Basic
 
 	String::String(string value)
 	{
-		this->value = value;
+		this->value = make_shared<const string>(std::move(value));
 	}
 
-	String::String(const String &other)
+	String::String(const String &other) : Data(other)
 	{
 		this->value = other.value;
-		this->pos_start = other.pos_start;
-		this->pos_end = other.pos_end;
-		this->context = other.context;
 	}
 
 	DataPtr String::clone()
 	{
+		Stats::cloned();
 		return make_Dataptr<String>(*this);
 	}
 
@@ -353,7 +366,7 @@ namespace Basic
 		{
 			String *other_str = raw_Dataptr<String>(other);
 
-			String result(this->value + other_str->value);
+			String result(*this->value + *other_str->value);
 			result.set_context(this->context);
 
 			return make_Dataptr<String>(result);
@@ -372,9 +385,9 @@ namespace Basic
 		{
 			Number *other_num = raw_Dataptr<Number>(other);
 
-			string str = this->value;
+			string str = *this->value;
 			for (size_t i = 1; i < other_num->get_value(true); i++)
-				str += this->value;
+				str += *this->value;
 
 			String result(str);
 			result.set_context(this->context);
@@ -395,6 +408,7 @@ namespace Basic
 		{
 			Number *other_num = raw_Dataptr<Number>(other);
 			int index = other_num->get_value(true);
+			const string &value = *this->value;
 
 			// 越界会触发exception
 			try
@@ -422,7 +436,7 @@ namespace Basic
 		else
 		{
 			String *ptr = raw_Dataptr<String>(other);
-			if (this->value == ptr->value)
+			if (*this->value == *ptr->value)
 				return make_Dataptr<Number>(1);
 			else
 				return make_Dataptr<Number>(0);
@@ -440,7 +454,7 @@ namespace Basic
 		else
 		{
 			String *ptr = raw_Dataptr<String>(other);
-			if (this->value != ptr->value)
+			if (*this->value != *ptr->value)
 				return make_Dataptr<Number>(1);
 			else
 				return make_Dataptr<Number>(0);
@@ -451,46 +465,54 @@ namespace Basic
 
 	bool String::is_true()
 	{
-		return this->value.length() > 0;
+		return this->value->length() > 0;
 	}
 
 	string String::repr()
 	{
-		return Basic::format("\"%s\"", value.c_str());
+		return Basic::format("\"%s\"", value->c_str());
 	}
 
-	string String::str()
+	const string &String::str()
 	{
-		return value;
+		return *this->value;
 	}
 
-	string String::getValue()
+	const string &String::getValue()
 	{
-		return this->value;
+		return *this->value;
 	}
 
 	List::List(const vector<DataPtr> &elems)
 	{
-		this->elements = elems;
+		this->elements = make_shared<vector<DataPtr>>(elems);
+		this->length = elems.size();
 	}
 
-	List::List(const List &other)
+	List::List(vector<DataPtr> &&elems)
 	{
+		this->length = elems.size();
+		this->elements = make_shared<vector<DataPtr>>(std::move(elems));
+	}
+
+	List::List(const List &other) : Data(other)
+	{
+		// 共享存储，双方都固定各自的长度
+		other.length = other.size();
 		this->elements = other.elements;
-		this->pos_start = other.pos_start;
-		this->pos_end = other.pos_end;
-		this->context = other.context;
+		this->length = other.length;
 	}
 
 	DataPtr List::clone()
 	{
+		Stats::cloned();
 		return make_Dataptr<List>(*this);
 	}
 
 	DataPtr List::added_to(const DataPtr &other)
 	{
 		List result(*this);
-		result.elements.push_back(other);
+		result.push(other);
 		return make_Dataptr<List>(result);
 	}
 
@@ -504,8 +526,11 @@ namespace Basic
 		{
 			List *other_list = raw_Dataptr<List>(other);
 			List result(*this);
-			for (auto &elem : other_list->elements)
-				result.elements.push_back(elem);
+
+			// 两者可能是同一个List，先确定要追加的个数
+			size_t count = other_list->size();
+			for (size_t i = 0; i < count; i++)
+				result.push((*other_list->elements)[i]);
 
 			return make_Dataptr<List>(result);
 		}
@@ -523,16 +548,17 @@ namespace Basic
 		{
 			Number *other_num = raw_Dataptr<Number>(other);
 			List result(*this);
+			vector<DataPtr> &result_elements = result.get_elements();
 
 			int index = other_num->get_value(true);
 
-			if (index >= 0 && index < result.elements.size())
+			if (index >= 0 && index < result_elements.size())
 			{
-				result.elements.erase(result.elements.begin() + index);
+				result_elements.erase(result_elements.begin() + index);
 			}
-			else if (index < 0 && (-index) < result.elements.size())
+			else if (index < 0 && (-index) < result_elements.size())
 			{
-				result.elements.erase(result.elements.end() + index);
+				result_elements.erase(result_elements.end() + index);
 			}
 			else
 				throw RunTimeError((*other)->pos_start, (*other)->pos_end, "Element can't be removed, Index out of bound", *this->context);
@@ -553,19 +579,15 @@ namespace Basic
 		{
 			Number *other_num = raw_Dataptr<Number>(other);
 			int index = other_num->get_value(true);
+			int count = size();
 
-			// 越界会触发exception
-			try
-			{
-				if (index >= 0)
-					return elements.at(index);
-				else
-					return elements.at(elements.size() + index);
-			}
-			catch (const std::exception &e)
-			{
+			if (index < 0)
+				index += count;
+
+			if (index < 0 || index >= count)
 				throw RunTimeError((*other)->pos_start, (*other)->pos_end, "List fetch, element out of bound", *this->context);
-			}
+
+			return (*elements)[index];
 		}
 
 		return nullptr;
@@ -580,7 +602,7 @@ namespace Basic
 		else
 		{
 			List *ptr = raw_Dataptr<List>(other);
-			if (this->elements == ptr->elements)
+			if (this->size() == ptr->size() && std::equal(this->begin(), this->end(), ptr->begin()))
 				return make_Dataptr<Number>(1);
 			else
 				return make_Dataptr<Number>(0);
@@ -598,10 +620,10 @@ namespace Basic
 		else
 		{
 			List *ptr = raw_Dataptr<List>(other);
-			if (this->elements != ptr->elements)
-				return make_Dataptr<Number>(1);
-			else
+			if (this->size() == ptr->size() && std::equal(this->begin(), this->end(), ptr->begin()))
 				return make_Dataptr<Number>(0);
+			else
+				return make_Dataptr<Number>(1);
 		}
 
 		return nullptr;
@@ -611,7 +633,7 @@ namespace Basic
 	{
 		string result = "[";
 
-		for (auto const &elem : elements)
+		for (auto const &elem : *this)
 		{
 			// 防止列表中插入自身，进入无限循环到栈溢出
 			if (&(**elem) == this)
@@ -633,22 +655,62 @@ namespace Basic
 		return result;
 	}
 
+	size_t List::size() const
+	{
+		return this->length == string::npos ? this->elements->size() : this->length;
+	}
+
+	vector<DataPtr>::const_iterator List::begin() const
+	{
+		return this->elements->cbegin();
+	}
+
+	vector<DataPtr>::const_iterator List::end() const
+	{
+		return this->elements->cbegin() + size();
+	}
+
 	vector<DataPtr> &List::get_elements()
 	{
-		return this->elements;
+		if (this->elements.use_count() > 1)
+			this->elements = make_shared<vector<DataPtr>>(begin(), end());
+		else
+			this->elements->resize(size()); // 丢弃其他共享者（已销毁）追加的元素
+
+		this->length = string::npos;
+		return *this->elements;
+	}
+
+	void List::push(const DataPtr &elem)
+	{
+		if (this->length != string::npos && this->elements->size() == this->length)
+		{
+			// 之后的元素其他共享者看不到，直接追加到共享存储中
+			this->elements->push_back(elem);
+			this->length++;
+		}
+		else
+			get_elements().push_back(elem);
 	}
 
-	Dict::Dict(const map<string, DataPtr> &elem)
+	Dict::Dict(const DictTable &elem)
 	{
-		this->elements = elem;
+		this->elements = make_shared<DictTable>(elem);
 	}
 
-	Dict::Dict(const Dict &other)
+	Dict::Dict(DictTable &&elem)
+	{
+		this->elements = make_shared<DictTable>(std::move(elem));
+	}
+
+	Dict::Dict(const Dict &other) : Data(other)
 	{
 		this->elements = other.elements;
-		this->pos_start = other.pos_start;
-		this->pos_end = other.pos_end;
-		this->context = other.context;
+	}
+
+	const DictTable &Dict::get_table() const
+	{
+		return *this->elements;
 	}
 
 	DataPtr Dict::index_by(const DataPtr &other)
@@ -659,13 +721,14 @@ namespace Basic
 		}
 		else
 		{
-			string attr = raw_Dataptr<String>(other)->getValue();
-			if (elements.find(attr) == elements.end())
+			const string &attr = raw_Dataptr<String>(other)->getValue();
+			const DataPtr *result = elements->find(attr);
+			if (result == nullptr)
 			{
 				throw RunTimeError((*other)->pos_start, (*other)->pos_end, "Undefined attribute " + attr, *this->context);
 			}
 
-			return elements[attr];
+			return *result;
 		}
 
 		return nullptr;
@@ -678,16 +741,20 @@ namespace Basic
 			throw RunTimeError(attribute.pos_start, attribute.pos_end, "Expected Attribute", *this->context);
 		}
 
-		if (elements.find(attribute.value) == elements.end())
-		{
-			elements[attribute.value] = make_Dataptr<Data>();
-		}
+		const DataPtr *result = elements->find(attribute.value);
+		if (result != nullptr)
+			return *result;
 
-		return elements[attribute.value];
+		// 未定义的属性会被自动插入
+		DataPtr &value = mutable_elements()[attribute.value];
+		value = make_Dataptr<Data>();
+
+		return value;
 	}
 
 	DataPtr Dict::clone()
 	{
+		Stats::cloned();
 		return make_Dataptr<Dict>(*this);
 	}
 
@@ -695,19 +762,19 @@ namespace Basic
 	{
 		string result = "{";
 
-		for (auto const &elem : elements)
+		for (auto const &elem : *elements)
 		{
-			result += elem.first;
+			result += elem.key;
 			result.push_back(':');
 
 			// 防止字典中有指向自身的项，进入无限循环到栈溢出
-			if (&(**(elem.second)) == this)
+			if (&(**(elem.value)) == this)
 			{
 				result += "{...}";
 			}
 			else
 			{
-				result += (*elem.second)->repr();
+				result += (*elem.value)->repr();
 			}
 			result.push_back(',');
 		}
@@ -720,44 +787,56 @@ namespace Basic
 		return result;
 	}
 
+	DictTable &Dict::mutable_elements()
+	{
+		if (this->elements.use_count() > 1)
+			this->elements = make_shared<DictTable>(*this->elements);
+
+		return *this->elements;
+	}
+
 	BaseFunction::BaseFunction(const string &func_name)
 	{
 		this->func_name = func_name;
 	}
 
-	BaseFunction::BaseFunction(const BaseFunction &other)
+	BaseFunction::BaseFunction(const BaseFunction &other) : Data(other)
 	{
 		this->func_name = other.func_name;
-		this->pos_start = other.pos_start;
-		this->pos_end = other.pos_end;
-		this->context = other.context;
 	}
 
 	DataPtr BaseFunction::clone()
 	{
+		Stats::cloned();
 		return make_Dataptr<BaseFunction>(*this);
 	}
 
 	Context BaseFunction::generate_new_context()
 	{
-		Context func_context(this->func_name, make_shared<Context>(*this->context), this->pos_start);
+		// 只引用调用者的上下文与符号表，不做拷贝
+		Context func_context(this->func_name, this->context, this->pos_start);
 
-		func_context.set_symbol_table(SymbolTable(make_shared<SymbolTable>((func_context.get_parent()->get_symbol_table()))));
+		func_context.set_symbol_table(make_shared<SymbolTable>(this->context->get_shared_symbol_table()));
 
 		return func_context;
 	}
 
 	RuntimeResult BaseFunction::check_args(const vector<string> &arg_names, const vector<DataPtr> &args)
+	{
+		return check_args(arg_names, args, this->pos_start, this->pos_end, *this->context);
+	}
+
+	RuntimeResult BaseFunction::check_args(const vector<string> &arg_names, const vector<DataPtr> &args, const Position &start, const Position &end, Context &context)
 	{
 		RuntimeResult res;
 		if (args.size() > arg_names.size())
 		{
-			return res.failure(make_shared<RunTimeError>(this->pos_start, this->pos_end, std::to_string(args.size() - arg_names.size()) + " too many args passed into " + this->func_name, *this->context));
+			return res.failure(make_shared<RunTimeError>(start, end, std::to_string(args.size() - arg_names.size()) + " too many args passed into " + this->func_name, context));
 		}
 
 		if (args.size() < arg_names.size())
 		{
-			return res.failure(make_shared<RunTimeError>(this->pos_start, this->pos_end, std::to_string(arg_names.size() - args.size()) + " too few args passed into " + this->func_name, *this->context));
+			return res.failure(make_shared<RunTimeError>(start, end, std::to_string(arg_names.size() - args.size()) + " too few args passed into " + this->func_name, context));
 		}
 
 		return res.success(nullptr);
@@ -795,9 +874,12 @@ namespace Basic
 		return Basic::format("<function %s>", func_name.c_str());
 	}
 
-	Function::Function(const string &func_name, const shared_ptr<ASTNode> &body_node, const vector<string> &arg_names, bool auto_return) : BaseFunction(func_name)
+	Function::Function(const string &func_name, ASTNode *body_node, const shared_ptr<AstArena> &arena, const vector<string> &arg_names, bool auto_return, const shared_ptr<Chunk> &chunk, const shared_ptr<Environment> &closure) : BaseFunction(func_name)
 	{
 		this->body_node = body_node;
+		this->arena = arena;
+		this->chunk = chunk;
+		this->closure = closure;
 		this->arg_names = arg_names;
 		this->auto_return = auto_return;
 	}
@@ -805,32 +887,89 @@ namespace Basic
 	Function::Function(const Function &other) : BaseFunction(other)
 	{
 		this->body_node = other.body_node;
+		this->arena = other.arena;
+		this->chunk = other.chunk;
+		this->closure = other.closure;
 		this->arg_names = other.arg_names;
 		this->auto_return = other.auto_return;
 	}
 
 	DataPtr Function::clone()
 	{
+		Stats::cloned();
 		return make_Dataptr<Function>(*this);
 	}
 
 	RuntimeResult Function::execute(vector<DataPtr> &args)
 	{
 		RuntimeResult res;
-		Interpreter interpreter;
-		Context func_context = generate_new_context();
 
-		res.registry(check_populate_args(this->arg_names, args, func_context));
-		if (res.should_return())
-			return res;
+		// 函数以尾调用结束时换成被调用的函数，在此循环中接着执行，调用层数不再增长
+		// 各层的上文都是最初的调用者，被省略的中间层不出现在错误栈中
+		Function *func = this;
+		vector<DataPtr> *func_args = &args;
+		Context func_context;
+
+		DataPtr tail_callee; // 保持尾调用的函数存活
+		vector<DataPtr> tail_args;
+		shared_ptr<TailCall> tail_call;
+
+		DataPtr value;
+		while (true)
+		{
+			if (tail_call != nullptr)
+			{
+				tail_callee = tail_call->callee;
+				tail_args = std::move(tail_call->args);
+				func = raw_Dataptr<Function>(tail_callee);
+				func_args = &tail_args;
+				res.reset();
+			}
+
+			{
+				Profiler::Scope profile_scope(func->func_name, this->pos_start);
+				Tracer::Scope trace_scope("function", func->func_name, this->pos_start);
+				Stats::function_called();
+
+				func_context = Context(func->func_name, this->context, this->pos_start);
+				if (func_context.get_depth() > Context::get_max_depth() || Context::stack_exhausted())
+					return res.failure(make_shared<RunTimeError>(this->pos_start, this->pos_end, "Maximum recursion depth exceeded", *this->context));
+
+				if (func->chunk != nullptr)
+				{
+					shared_ptr<Environment> env;
+					res.registry(func->bind(*func_args, func_context, env, this->pos_start, this->pos_end));
+					if (res.should_return())
+						return res;
+
+					VM vm;
+					value = res.registry(vm.run(func->chunk, func_context, env));
+				}
+				else
+				{
+					// 与bind相同，按名称查找的变量从定义该函数的环境中获取，而非调用者
+					func_context.set_symbol_table(make_shared<SymbolTable>(func->closure->symbols));
+
+					res.registry(check_populate_args(func->arg_names, *func_args, func_context));
+					if (res.should_return())
+						return res;
+
+					Interpreter interpreter(func->arena);
+					value = res.registry(interpreter.visit(func->body_node, func_context));
+				}
+			}
+
+			tail_call = res.get_tail_call();
+			if (tail_call == nullptr)
+				break;
+		}
 
-		DataPtr value = res.registry(interpreter.visit(body_node, func_context));
 		DataPtr func_return_value = res.get_func_return_value();
 		if (res.should_return() && func_return_value == nullptr)
 			return res;
 
 		// 正常情况。单行返回value，多行有return返回return的值，没有返回空
-		DataPtr return_value = this->auto_return ? value : nullptr;
+		DataPtr return_value = func->auto_return ? value : nullptr;
 
 		// in case有人在单行中写return语句，所以我们这样写，可以确保单行也可以使用return的值
 		if (return_value == nullptr && func_return_value != nullptr)
@@ -841,21 +980,105 @@ namespace Basic
 		return res.success(return_value);
 	}
 
+	RuntimeResult Function::bind(vector<DataPtr> &args, Context &func_context, shared_ptr<Environment> &env, const Position &call_start, const Position &call_end)
+	{
+		RuntimeResult res;
+		res.registry(check_args(this->arg_names, args, call_start, call_end, *func_context.get_parent()));
+		if (res.should_return())
+			return res;
+
+		// 按名称查找的变量从定义该函数的环境中获取，而非调用者
+		env = make_shared<Environment>(this->chunk, this->closure, make_shared<SymbolTable>(this->closure->symbols));
+		func_context.set_symbol_table(env->symbols);
+
+		// 参数直接放入槽位，不经过符号表
+		for (size_t i = 0; i < args.size(); i++)
+		{
+			(*args[i])->set_context(&func_context);
+			// 参数可能是调用者变量的引用（&x），保持装箱以共享同一个对象
+			env->slots[this->chunk->arg_slots[i]] = Value(args[i]);
+		}
+
+		return res.success(nullptr);
+	}
+
+	MemoFunction::MemoFunction(const DataPtr &func, size_t capacity) : BaseFunction(raw_Dataptr<Function>(func)->get_func_name())
+	{
+		this->func = func;
+		this->cache = make_shared<MemoCache>(capacity);
+	}
+
+	MemoFunction::MemoFunction(const MemoFunction &other) : BaseFunction(other)
+	{
+		this->func = other.func;
+		this->cache = other.cache;
+	}
+
+	DataPtr MemoFunction::clone()
+	{
+		Stats::cloned();
+		return make_Dataptr<MemoFunction>(*this);
+	}
+
+	RuntimeResult MemoFunction::execute(vector<DataPtr> &args)
+	{
+		RuntimeResult res;
+
+		string key;
+		bool cacheable = MemoCache::make_key(args, key);
+		if (cacheable)
+		{
+			DataPtr cached = this->cache->get(key);
+			if (cached != nullptr)
+				return res.success((*cached)->clone());
+		}
+
+		// 递归调用会再次进入这里，各次调用使用各自的拷贝，互不覆盖位置与上下文
+		DataPtr callee = (*this->func)->clone();
+		(*callee)->set_pos(this->pos_start, this->pos_end);
+		(*callee)->set_context(this->context);
+
+		DataPtr value = res.registry((*callee)->execute(args));
+		if (res.should_return())
+			return res;
+
+		if (cacheable)
+			this->cache->put(key, (*value)->clone());
+
+		return res.success(value);
+	}
+
+	const DataPtr &MemoFunction::get_func()
+	{
+		return this->func;
+	}
+
+	const shared_ptr<MemoCache> &MemoFunction::get_cache()
+	{
+		return this->cache;
+	}
+
 	BuiltInFunction::BuiltInFunction(const string &func_name) : BaseFunction(func_name)
 	{
+		auto found = specs.find(func_name);
+		this->spec = found != specs.end() ? &found->second : nullptr;
 	}
 
 	BuiltInFunction::BuiltInFunction(const BuiltInFunction &other) : BaseFunction(other)
 	{
+		this->spec = other.spec;
 	}
 
 	string BuiltInFunction::repr()
 	{
 		string result = Basic::format("<built-in function %s>(", func_name.c_str());
-		for (const string &arg_name : func_args_map.find(func_name)->second)
+		if (this->spec != nullptr)
 		{
-			result += arg_name;
-			result += ",";
+			for (const string &arg_name : this->spec->arg_names)
+			{
+				result += arg_name;
+				result += ",";
+			}
 		}
 		result.pop_back();
 		result += ")";
@@ -865,40 +1088,39 @@ namespace Basic
 
 	DataPtr BuiltInFunction::clone()
 	{
+		Stats::cloned();
 		return make_Dataptr<BuiltInFunction>(*this);
 	}
 
 	RuntimeResult BuiltInFunction::execute(vector<DataPtr> &args)
 	{
+		Profiler::Scope profile_scope(this->func_name, this->pos_start);
+		Tracer::Scope trace_scope("builtin", this->func_name, this->pos_start);
+		Stats::builtin_called();
 		RuntimeResult res;
-		Context func_context = generate_new_context();
 
-		auto method_ptr = func_name_map.find(func_name);
+		// 参数按位置传给实现，不经过符号表，因此沿用调用者的符号表
+		Context func_context(this->func_name, this->context, this->pos_start, this->context->get_shared_symbol_table());
 
-		function<RuntimeResult(BuiltInFunction *, Context &)> method;
-		if (method_ptr != func_name_map.end())
-			method = method_ptr->second;
-		else
+		if (this->spec == nullptr)
 			return res.failure(make_shared<RunTimeError>(this->pos_start, this->pos_end, "No execution method_" + this->func_name + " defined", func_context));
 
-		// 找到函数了，那么必然有对应的参数列表
-		// 所以不检查find的合法性了
-		res.registry(check_populate_args(func_args_map.find(func_name)->second, args, func_context));
+		res.registry(check_args(this->spec->arg_names, args));
 		if (res.should_return())
 			return res;
 
-		DataPtr return_value = res.registry(method(this, func_context));
+		DataPtr return_value = res.registry((this->*spec->method)(func_context, args));
 		if (res.should_return())
 			return res;
 
 		return res.success(return_value);
 	}
 
-	RuntimeResult BuiltInFunction::execute_run(Context &exec_ctx)
+	RuntimeResult BuiltInFunction::execute_run(Context &exec_ctx, vector<DataPtr> &args)
 	{
 		RuntimeResult res;
 
-		DataPtr filename_node = exec_ctx.get_symbol_table().get("filename");
+		const DataPtr &filename_node = args[0];
 		if (typeid(**filename_node) != typeid(String))
 		{
 			return res.failure(make_shared<RunTimeError>(this->pos_start, this->pos_end, "Filename must be String", exec_ctx));
@@ -906,15 +1128,13 @@ namespace Basic
 
 		string filename = raw_Dataptr<String>(filename_node)->getValue();
 
-		auto text = readfile(filename);
+		auto result = Basic::run_file(filename);
 
-		if (text.has_value())
+		if (result.has_value())
 		{
-			auto result = Basic::run(filename, text.value());
-
-			if (std::get<1>(result) != nullptr)
+			if (std::get<1>(result.value()) != nullptr)
 			{
-				return res.failure(make_shared<RunTimeError>(this->pos_start, this->pos_end, "Failed to finish executing script " + filename + "\n\n" + std::get<1>(result)->as_string(), exec_ctx));
+				return res.failure(make_shared<RunTimeError>(this->pos_start, this->pos_end, "Failed to finish executing script " + filename + "\n\n" + std::get<1>(result.value())->as_string(), exec_ctx));
 			}
 		}
 		else
@@ -925,10 +1145,10 @@ namespace Basic
 		return res.success(make_Dataptr<Data>());
 	}
 
-	RuntimeResult BuiltInFunction::execute_print(Context &exec_ctx)
+	RuntimeResult BuiltInFunction::execute_print(Context &exec_ctx, vector<DataPtr> &args)
 	{
 		RuntimeResult res;
-		DataPtr value = exec_ctx.get_symbol_table().get("value");
+		const DataPtr &value = args[0];
 
 		if (typeid(**value) == typeid(String))
 			Basic::printf("%s\n", raw_Dataptr<String>(value)->str());
@@ -938,12 +1158,12 @@ namespace Basic
 		return res.success(make_Dataptr<Data>());
 	}
 
-	RuntimeResult BuiltInFunction::execute_prints(Context &exec_ctx)
+	RuntimeResult BuiltInFunction::execute_prints(Context &exec_ctx, vector<DataPtr> &args)
 	{
 		RuntimeResult res;
 
-		DataPtr values = exec_ctx.get_symbol_table().get("values");
-		DataPtr ends_with = exec_ctx.get_symbol_table().get("ends_with");
+		const DataPtr &values = args[0];
+		const DataPtr &ends_with = args[1];
 
 		if (typeid(**values) != typeid(List))
 			return res.failure(make_shared<RunTimeError>(this->pos_start, this->pos_end, "Expected a List of elements for first argument", exec_ctx));
@@ -952,10 +1172,9 @@ namespace Basic
 
 		List *list_node = raw_Dataptr<List>(values);
 		String *end_node = raw_Dataptr<String>(ends_with);
-		vector<DataPtr> &list = list_node->get_elements();
-		string end_value = end_node->getValue();
+		const string &end_value = end_node->getValue();
 
-		for (const DataPtr &elem : list)
+		for (const DataPtr &elem : *list_node)
 		{
 			if (typeid(**elem) == typeid(String))
 				Basic::printf("%s ", raw_Dataptr<String>(elem)->str());
@@ -967,10 +1186,10 @@ namespace Basic
 		return res.success(make_Dataptr<Data>());
 	}
 
-	RuntimeResult BuiltInFunction::execute_print_ret(Context &exec_ctx)
+	RuntimeResult BuiltInFunction::execute_print_ret(Context &exec_ctx, vector<DataPtr> &args)
 	{
 		RuntimeResult res;
-		DataPtr value = exec_ctx.get_symbol_table().get("value");
+		const DataPtr &value = args[0];
 		string repr;
 
 		if (typeid(**value) == typeid(String))
@@ -981,7 +1200,7 @@ namespace Basic
 		return res.success(make_Dataptr<String>(repr));
 	}
 
-	RuntimeResult BuiltInFunction::execute_input(Context &exec_ctx)
+	RuntimeResult BuiltInFunction::execute_input(Context &, vector<DataPtr> &)
 	{
 		RuntimeResult res;
 		string text;
@@ -989,7 +1208,7 @@ namespace Basic
 		return res.success(make_Dataptr<String>(text));
 	}
 
-	RuntimeResult BuiltInFunction::execute_input_num(Context &exec_ctx)
+	RuntimeResult BuiltInFunction::execute_input_num(Context &, vector<DataPtr> &)
 	{
 		RuntimeResult res;
 		string input_value;
@@ -1009,7 +1228,7 @@ namespace Basic
 		return res.success(make_Dataptr<Data>());
 	}
 
-	RuntimeResult BuiltInFunction::execute_clear(Context &exec_ctx)
+	RuntimeResult BuiltInFunction::execute_clear(Context &, vector<DataPtr> &)
 	{
 		RuntimeResult res;
 #if defined _WIN32
@@ -1023,10 +1242,10 @@ namespace Basic
 		return res.success(make_Dataptr<Data>());
 	}
 
-	RuntimeResult BuiltInFunction::execute_is_number(Context &exec_ctx)
+	RuntimeResult BuiltInFunction::execute_is_number(Context &exec_ctx, vector<DataPtr> &args)
 	{
 		RuntimeResult res;
-		DataPtr value = exec_ctx.get_symbol_table().get("value");
+		const DataPtr &value = args[0];
 		if (typeid(**value) == typeid(Number))
 		{
 			return res.success(make_Dataptr<Number>(Number::TRUE));
@@ -1035,10 +1254,10 @@ namespace Basic
 		return res.success(make_Dataptr<Number>(Number::FALSE));
 	}
 
-	RuntimeResult BuiltInFunction::execute_is_string(Context &exec_ctx)
+	RuntimeResult BuiltInFunction::execute_is_string(Context &exec_ctx, vector<DataPtr> &args)
 	{
 		RuntimeResult res;
-		DataPtr value = exec_ctx.get_symbol_table().get("value");
+		const DataPtr &value = args[0];
 		if (typeid(**value) == typeid(String))
 		{
 			return res.success(make_Dataptr<Number>(Number::TRUE));
@@ -1047,10 +1266,10 @@ namespace Basic
 		return res.success(make_Dataptr<Number>(Number::FALSE));
 	}
 
-	RuntimeResult BuiltInFunction::execute_is_list(Context &exec_ctx)
+	RuntimeResult BuiltInFunction::execute_is_list(Context &exec_ctx, vector<DataPtr> &args)
 	{
 		RuntimeResult res;
-		DataPtr value = exec_ctx.get_symbol_table().get("value");
+		const DataPtr &value = args[0];
 		if (typeid(**value) == typeid(List))
 		{
 			return res.success(make_Dataptr<Number>(Number::TRUE));
@@ -1059,11 +1278,11 @@ namespace Basic
 		return res.success(make_Dataptr<Number>(Number::FALSE));
 	}
 
-	RuntimeResult BuiltInFunction::execute_is_function(Context &exec_ctx)
+	RuntimeResult BuiltInFunction::execute_is_function(Context &exec_ctx, vector<DataPtr> &args)
 	{
 		RuntimeResult res;
-		DataPtr value = exec_ctx.get_symbol_table().get("value");
-		if (typeid(**value) == typeid(Function) || typeid(**value) == typeid(BuiltInFunction))
+		const DataPtr &value = args[0];
+		if (typeid(**value) == typeid(Function) || typeid(**value) == typeid(BuiltInFunction) || typeid(**value) == typeid(MemoFunction))
 		{
 			return res.success(make_Dataptr<Number>(Number::TRUE));
 		}
@@ -1071,15 +1290,15 @@ namespace Basic
 		return res.success(make_Dataptr<Number>(Number::FALSE));
 	}
 
-	RuntimeResult BuiltInFunction::execute_len(Context &exec_ctx)
+	RuntimeResult BuiltInFunction::execute_len(Context &exec_ctx, vector<DataPtr> &args)
 	{
 		RuntimeResult res;
-		DataPtr value_node = exec_ctx.get_symbol_table().get("value");
+		const DataPtr &value_node = args[0];
 
 		if (typeid(**value_node) == typeid(List))
 		{
 			List *list_node = raw_Dataptr<List>(value_node);
-			return res.success(make_Dataptr<Number>(list_node->get_elements().size()));
+			return res.success(make_Dataptr<Number>(list_node->size()));
 		}
 		else if (typeid(**value_node) == typeid(String))
 		{
@@ -1094,12 +1313,12 @@ namespace Basic
 		return res.success(make_Dataptr<Number>(Number::null));
 	}
 
-	RuntimeResult BuiltInFunction::execute_append(Context &exec_ctx)
+	RuntimeResult BuiltInFunction::execute_append(Context &exec_ctx, vector<DataPtr> &args)
 	{
 		RuntimeResult res;
 
-		DataPtr first_arg = exec_ctx.get_symbol_table().get("list");
-		DataPtr second_arg = exec_ctx.get_symbol_table().get("value");
+		const DataPtr &first_arg = args[0];
+		const DataPtr &second_arg = args[1];
 
 		if (typeid(**first_arg) != typeid(List))
 			return res.failure(make_shared<RunTimeError>(this->pos_start, this->pos_end, "First argument must be a list", *this->context));
@@ -1110,17 +1329,19 @@ namespace Basic
 		// 故该函数为mutable，而added_to会返回一个新的值
 
 		// TODO: 目前append和mutate对于插入自己的处理不一致
-		list->get_elements().push_back((*second_arg)->clone());
+		// 先拷贝再取存储：拷贝自身会使get_elements()返回的引用失效
+		DataPtr value = (*second_arg)->clone();
+		list->get_elements().push_back(value);
 
 		return res.success(make_Dataptr<Data>());
 	}
 
-	RuntimeResult BuiltInFunction::execute_pop(Context &exec_ctx)
+	RuntimeResult BuiltInFunction::execute_pop(Context &exec_ctx, vector<DataPtr> &args)
 	{
 		RuntimeResult res;
 
-		DataPtr first_arg = exec_ctx.get_symbol_table().get("list");
-		DataPtr second_arg = exec_ctx.get_symbol_table().get("index");
+		const DataPtr &first_arg = args[0];
+		const DataPtr &second_arg = args[1];
 
 		if (typeid(**first_arg) != typeid(List))
 			return res.failure(make_shared<RunTimeError>(this->pos_start, this->pos_end, "First argument must be a list", *this->context));
@@ -1151,11 +1372,11 @@ namespace Basic
 		return res.success(return_data);
 	}
 
-	RuntimeResult BuiltInFunction::execute_pop_front(Context &exec_ctx)
+	RuntimeResult BuiltInFunction::execute_pop_front(Context &exec_ctx, vector<DataPtr> &args)
 	{
 		RuntimeResult res;
 
-		DataPtr list_ptr = exec_ctx.get_symbol_table().get("list");
+		const DataPtr &list_ptr = args[0];
 
 		if (typeid(**list_ptr) != typeid(List))
 			return res.failure(make_shared<RunTimeError>(this->pos_start, this->pos_end, "First argument must be a list", *this->context));
@@ -1174,10 +1395,10 @@ namespace Basic
 		return res.success(return_data);
 	}
 
-	RuntimeResult BuiltInFunction::execute_pop_back(Context &exec_ctx)
+	RuntimeResult BuiltInFunction::execute_pop_back(Context &exec_ctx, vector<DataPtr> &args)
 	{
 		RuntimeResult res;
-		DataPtr list_ptr = exec_ctx.get_symbol_table().get("list");
+		const DataPtr &list_ptr = args[0];
 
 		if (typeid(**list_ptr) != typeid(List))
 			return res.failure(make_shared<RunTimeError>(this->pos_start, this->pos_end, "First argument must be a list", *this->context));
@@ -1196,11 +1417,11 @@ namespace Basic
 		return res.success(return_data);
 	}
 
-	RuntimeResult BuiltInFunction::execute_extend(Context &exec_ctx)
+	RuntimeResult BuiltInFunction::execute_extend(Context &exec_ctx, vector<DataPtr> &args)
 	{
 		RuntimeResult res;
-		DataPtr first_arg = exec_ctx.get_symbol_table().get("list1");
-		DataPtr second_arg = exec_ctx.get_symbol_table().get("list2");
+		const DataPtr &first_arg = args[0];
+		const DataPtr &second_arg = args[1];
 
 		if (typeid(**first_arg) != typeid(List) || typeid(**second_arg) != typeid(List))
 			return res.failure(make_shared<RunTimeError>(this->pos_start, this->pos_end, "Both arguments must be list", *this->context));
@@ -1208,8 +1429,9 @@ namespace Basic
 		List *list1 = raw_Dataptr<List>(first_arg);
 		List *list2 = raw_Dataptr<List>(second_arg);
 
+		// list1与list2可能是同一个List，先取出要追加的元素
+		vector<DataPtr> list2_value(list2->begin(), list2->end());
 		vector<DataPtr> &list1_value = list1->get_elements();
-		vector<DataPtr> &list2_value = list2->get_elements();
 
 		for (auto &data : list2_value)
 			list1_value.push_back(data);
@@ -1217,17 +1439,89 @@ namespace Basic
 		return res.success(make_Dataptr<Data>());
 	}
 
-	RuntimeResult BuiltInFunction::execute_swap(Context &exec_ctx)
+	RuntimeResult BuiltInFunction::execute_swap(Context &exec_ctx, vector<DataPtr> &args)
 	{
 		RuntimeResult res;
-		DataPtr first_arg = exec_ctx.get_symbol_table().get("first");
-		DataPtr second_arg = exec_ctx.get_symbol_table().get("second");
+		const DataPtr &first_arg = args[0];
+		const DataPtr &second_arg = args[1];
 
 		(*first_arg).swap(*second_arg);
 
 		return res.success(make_Dataptr<Data>());
 	}
 
+	RuntimeResult BuiltInFunction::execute_stats(Context &, vector<DataPtr> &)
+	{
+		RuntimeResult res;
+
+		// 先取快照，构造结果本身产生的分配不计入
+		uint64_t allocations[static_cast<size_t>(DataKind::COUNT)];
+		std::copy(std::begin(Stats::allocations), std::end(Stats::allocations), allocations);
+		uint64_t hits[Stats::LOOKUP_DEPTHS], misses[Stats::LOOKUP_DEPTHS];
+		std::copy(std::begin(Stats::lookup_hits), std::end(Stats::lookup_hits), hits);
+		std::copy(std::begin(Stats::lookup_misses), std::end(Stats::lookup_misses), misses);
+		double clones = Stats::clones, live = Stats::live, peak_live = Stats::peak_live;
+		double function_calls = Stats::function_calls, builtin_calls = Stats::builtin_calls;
+
+		DictTable allocated;
+		for (size_t i = 0; i < static_cast<size_t>(DataKind::COUNT); i++)
+			allocated[Stats::kind_name(static_cast<DataKind>(i))] = make_Dataptr<Number>(allocations[i]);
+
+		vector<DataPtr> hit_list, miss_list;
+		for (size_t i = 0; i < Stats::LOOKUP_DEPTHS; i++)
+		{
+			hit_list.push_back(make_Dataptr<Number>(hits[i]));
+			miss_list.push_back(make_Dataptr<Number>(misses[i]));
+		}
+
+		DictTable stats;
+		stats["allocated"] = make_Dataptr<Dict>(std::move(allocated));
+		stats["clones"] = make_Dataptr<Number>(clones);
+		stats["live"] = make_Dataptr<Number>(live);
+		stats["peak_live"] = make_Dataptr<Number>(peak_live);
+		stats["function_calls"] = make_Dataptr<Number>(function_calls);
+		stats["builtin_calls"] = make_Dataptr<Number>(builtin_calls);
+		stats["lookup_hits"] = make_Dataptr<List>(std::move(hit_list));
+		stats["lookup_misses"] = make_Dataptr<List>(std::move(miss_list));
+
+		return res.success(make_Dataptr<Dict>(std::move(stats)));
+	}
+
+	RuntimeResult BuiltInFunction::execute_memo(Context &exec_ctx, vector<DataPtr> &args)
+	{
+		RuntimeResult res;
+		const DataPtr &func = args[0];
+		const DataPtr &size = args[1];
+
+		if (typeid(**func) != typeid(Function))
+			return res.failure(make_shared<RunTimeError>(this->pos_start, this->pos_end, "First argument must be a user-defined function", exec_ctx));
+
+		double capacity = typeid(**size) == typeid(Number) ? raw_Dataptr<Number>(size)->get_value() : 0;
+		if (!(capacity >= 1 && capacity <= UINT32_MAX) || std::floor(capacity) != capacity)
+			return res.failure(make_shared<RunTimeError>(this->pos_start, this->pos_end, "Second argument must be a positive integer size(Number)", exec_ctx));
+
+		return res.success(make_Dataptr<MemoFunction>(func, (size_t)capacity));
+	}
+
+	RuntimeResult BuiltInFunction::execute_memo_stats(Context &exec_ctx, vector<DataPtr> &args)
+	{
+		RuntimeResult res;
+		const DataPtr &func = args[0];
+
+		if (typeid(**func) != typeid(MemoFunction))
+			return res.failure(make_shared<RunTimeError>(this->pos_start, this->pos_end, "Argument must be a function returned by MEMO", exec_ctx));
+
+		const MemoCache &cache = *raw_Dataptr<MemoFunction>(func)->get_cache();
+
+		DictTable stats;
+		stats["hits"] = make_Dataptr<Number>((double)cache.get_hits());
+		stats["misses"] = make_Dataptr<Number>((double)cache.get_misses());
+		stats["size"] = make_Dataptr<Number>((double)cache.size());
+		stats["capacity"] = make_Dataptr<Number>((double)cache.get_capacity());
+
+		return res.success(make_Dataptr<Dict>(std::move(stats)));
+	}
+
 	// 静态成员赋值
 
 	const Number Number::null = Number(0);
@@ -1235,43 +1529,26 @@ namespace Basic
 	const Number Number::TRUE = Number(1);
 	const Number Number::MATH_PI = Number(3.14159265354);
 
-	const map<string, function<RuntimeResult(BuiltInFunction *, Context &)>> BuiltInFunction::func_name_map = map<string, function<RuntimeResult(BuiltInFunction *, Context &)>>{
-		pair<string, function<RuntimeResult(BuiltInFunction *, Context &)>>("RUN", &BuiltInFunction::execute_run),
-		pair<string, function<RuntimeResult(BuiltInFunction *, Context &)>>("PRINT", &BuiltInFunction::execute_print),
-		pair<string, function<RuntimeResult(BuiltInFunction *, Context &)>>("PRINTS", &BuiltInFunction::execute_prints),
-		pair<string, function<RuntimeResult(BuiltInFunction *, Context &)>>("PRINT_RET", &BuiltInFunction::execute_print_ret),
-		pair<string, function<RuntimeResult(BuiltInFunction *, Context &)>>("INPUT", &BuiltInFunction::execute_input),
-		pair<string, function<RuntimeResult(BuiltInFunction *, Context &)>>("INPUT_NUM", &BuiltInFunction::execute_input_num),
-		pair<string, function<RuntimeResult(BuiltInFunction *, Context &)>>("CLEAR", &BuiltInFunction::execute_clear),
-		pair<string, function<RuntimeResult(BuiltInFunction *, Context &)>>("IS_NUM", &BuiltInFunction::execute_is_number),
-		pair<string, function<RuntimeResult(BuiltInFunction *, Context &)>>("IS_STR", &BuiltInFunction::execute_is_string),
-		pair<string, function<RuntimeResult(BuiltInFunction *, Context &)>>("IS_LIST", &BuiltInFunction::execute_is_list),
-		pair<string, function<RuntimeResult(BuiltInFunction *, Context &)>>("IS_FUNC", &BuiltInFunction::execute_is_function),
-		pair<string, function<RuntimeResult(BuiltInFunction *, Context &)>>("LEN", &BuiltInFunction::execute_len),
-		pair<string, function<RuntimeResult(BuiltInFunction *, Context &)>>("APPEND", &BuiltInFunction::execute_append),
-		pair<string, function<RuntimeResult(BuiltInFunction *, Context &)>>("POP", &BuiltInFunction::execute_pop),
-		pair<string, function<RuntimeResult(BuiltInFunction *, Context &)>>("POP_BACK", &BuiltInFunction::execute_pop_back),
-		pair<string, function<RuntimeResult(BuiltInFunction *, Context &)>>("POP_FRONT", &BuiltInFunction::execute_pop_front),
-		pair<string, function<RuntimeResult(BuiltInFunction *, Context &)>>("EXTEND", &BuiltInFunction::execute_extend),
-		pair<string, function<RuntimeResult(BuiltInFunction *, Context &)>>("SWAP", &BuiltInFunction::execute_swap)};
-
-	const map<string, vector<string>> BuiltInFunction::func_args_map = map<string, vector<string>>{
-		pair<string, vector<string>>("RUN", vector<string>{"filename"}),
-		pair<string, vector<string>>("PRINT", vector<string>{"value"}),
-		pair<string, vector<string>>("PRINTS", vector<string>{"values", "ends_with"}),
-		pair<string, vector<string>>("PRINT_RET", vector<string>{"value"}),
-		pair<string, vector<string>>("INPUT", vector<string>()),
-		pair<string, vector<string>>("INPUT_NUM", vector<string>()),
-		pair<string, vector<string>>("CLEAR", vector<string>()),
-		pair<string, vector<string>>("IS_NUM", vector<string>{"value"}),
-		pair<string, vector<string>>("IS_STR", vector<string>{"value"}),
-		pair<string, vector<string>>("IS_LIST", vector<string>{"value"}),
-		pair<string, vector<string>>("IS_FUNC", vector<string>{"value"}),
-		pair<string, vector<string>>("LEN", vector<string>{"value"}),
-		pair<string, vector<string>>("APPEND", vector<string>{"list", "value"}),
-		pair<string, vector<string>>("POP", vector<string>{"list", "index"}),
-		pair<string, vector<string>>("POP_BACK", vector<string>{"list"}),
-		pair<string, vector<string>>("POP_FRONT", vector<string>{"list"}),
-		pair<string, vector<string>>("EXTEND", vector<string>{"list1", "list2"}),
-		pair<string, vector<string>>("SWAP", vector<string>{"first", "second"})};
-}
\ No newline at end of file
+	const map<string, BuiltInFunction::Spec> BuiltInFunction::specs = {
+		{"RUN", {&BuiltInFunction::execute_run, {"filename"}}},
+		{"PRINT", {&BuiltInFunction::execute_print, {"value"}}},
+		{"PRINTS", {&BuiltInFunction::execute_prints, {"values", "ends_with"}}},
+		{"PRINT_RET", {&BuiltInFunction::execute_print_ret, {"value"}}},
+		{"INPUT", {&BuiltInFunction::execute_input, {}}},
+		{"INPUT_NUM", {&BuiltInFunction::execute_input_num, {}}},
+		{"CLEAR", {&BuiltInFunction::execute_clear, {}}},
+		{"IS_NUM", {&BuiltInFunction::execute_is_number, {"value"}}},
+		{"IS_STR", {&BuiltInFunction::execute_is_string, {"value"}}},
+		{"IS_LIST", {&BuiltInFunction::execute_is_list, {"value"}}},
+		{"IS_FUNC", {&BuiltInFunction::execute_is_function, {"value"}}},
+		{"LEN", {&BuiltInFunction::execute_len, {"value"}}},
+		{"APPEND", {&BuiltInFunction::execute_append, {"list", "value"}}},
+		{"POP", {&BuiltInFunction::execute_pop, {"list", "index"}}},
+		{"POP_BACK", {&BuiltInFunction::execute_pop_back, {"list"}}},
+		{"POP_FRONT", {&BuiltInFunction::execute_pop_front, {"list"}}},
+		{"EXTEND", {&BuiltInFunction::execute_extend, {"list1", "list2"}}},
+		{"SWAP", {&BuiltInFunction::execute_swap, {"first", "second"}}},
+		{"STATS", {&BuiltInFunction::execute_stats, {}}},
+		{"MEMO", {&BuiltInFunction::execute_memo, {"func", "size"}}},
+		{"MEMO_STATS", {&BuiltInFunction::execute_memo_stats, {"func"}}}};
+}
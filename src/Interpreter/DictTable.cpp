@@ -0,0 +1,108 @@
+#include "Interpreter/DictTable.h"
+#include "Interpreter/Data.h"
+
+namespace Basic
+{
+	static const size_t MIN_SLOTS = 8;
+
+	void DictTable::reserve(size_t n)
+	{
+		entries.reserve(n);
+
+		// 负载因子不超过1/2
+		size_t slot_count = MIN_SLOTS;
+		while (slot_count < n * 2)
+			slot_count <<= 1;
+
+		if (slot_count > slots.size())
+			rehash(slot_count);
+	}
+
+	const shared_ptr<unique_ptr<Data>> *DictTable::find(string_view key) const
+	{
+		if (entries.empty())
+			return nullptr;
+
+		const Slot &slot = slots[probe(key, hash(key))];
+		if (slot.entry == 0)
+			return nullptr;
+
+		return &entries[slot.entry - 1].value;
+	}
+
+	shared_ptr<unique_ptr<Data>> &DictTable::operator[](string_view key)
+	{
+		if ((entries.size() + 1) * 2 > slots.size())
+			rehash(slots.empty() ? MIN_SLOTS : slots.size() * 2);
+
+		uint64_t h = hash(key);
+		Slot &slot = slots[probe(key, h)];
+		if (slot.entry == 0)
+		{
+			entries.push_back({string(key), h, nullptr});
+			slot.entry = entries.size();
+			slot.tag = h >> 32;
+		}
+
+		return entries[slot.entry - 1].value;
+	}
+
+	size_t DictTable::size() const
+	{
+		return entries.size();
+	}
+
+	vector<DictTable::Entry>::const_iterator DictTable::begin() const
+	{
+		return entries.cbegin();
+	}
+
+	vector<DictTable::Entry>::const_iterator DictTable::end() const
+	{
+		return entries.cend();
+	}
+
+	uint64_t DictTable::hash(string_view key)
+	{
+		// FNV-1a
+		uint64_t h = 14695981039346656037ULL;
+		for (unsigned char c : key)
+		{
+			h ^= c;
+			h *= 1099511628211ULL;
+		}
+		return h;
+	}
+
+	size_t DictTable::probe(string_view key, uint64_t hash) const
+	{
+		size_t mask = slots.size() - 1;
+		uint32_t tag = hash >> 32;
+
+		// 线性探测，表中总有空槽，故一定会结束
+		for (size_t i = hash & mask;; i = (i + 1) & mask)
+		{
+			const Slot &slot = slots[i];
+			if (slot.entry == 0)
+				return i;
+			if (slot.tag == tag && entries[slot.entry - 1].key == key)
+				return i;
+		}
+	}
+
+	void DictTable::rehash(size_t slot_count)
+	{
+		slots.assign(slot_count, {0, 0});
+		size_t mask = slot_count - 1;
+
+		for (size_t index = 0; index < entries.size(); index++)
+		{
+			size_t i = entries[index].hash & mask;
+			while (slots[i].entry != 0)
+				i = (i + 1) & mask;
+
+			slots[i].entry = index + 1;
+			slots[i].tag = entries[index].hash >> 32;
+		}
+	}
+}
@@ -2,101 +2,109 @@
 #include "Common/utils.h"
 #include "Interpreter/RunTimeError.h"
 #include "Interpreter/Data.h"
+#include "Common/Profiler.h"
+#include "VM/Environment.h"
 #include <functional>
 
-using std::static_pointer_cast;
 
 namespace Basic
 {
-	RuntimeResult Interpreter::visit(const shared_ptr<ASTNode> &root, Context &context, bool byRef)
+	Interpreter::Interpreter(const shared_ptr<AstArena> &arena)
 	{
+		this->arena = arena;
+	}
+
+	RuntimeResult Interpreter::visit(ASTNode *root, Context &context, bool byRef)
+	{
+		Profiler::poll(root->pos_start);
+
 		if (typeid(*root) == typeid(NumberNode))
 		{
-			return visit_NumberNode(static_pointer_cast<NumberNode>(root), context);
+			return visit_NumberNode(static_cast<NumberNode *>(root), context);
 		}
 		else if (typeid(*root) == typeid(StringNode))
 		{
-			return visit_StringNode(static_pointer_cast<StringNode>(root), context);
+			return visit_StringNode(static_cast<StringNode *>(root), context);
 		}
 		else if (typeid(*root) == typeid(ListNode))
 		{
-			return visit_ListNode(static_pointer_cast<ListNode>(root), context);
+			return visit_ListNode(static_cast<ListNode *>(root), context);
 		}
 		else if (typeid(*root) == typeid(DictNode))
 		{
-			return visit_DictNode(static_pointer_cast<DictNode>(root), context);
+			return visit_DictNode(static_cast<DictNode *>(root), context);
 		}
 		else if (typeid(*root) == typeid(IndexNode))
 		{
-			return visit_IndexNode(static_pointer_cast<IndexNode>(root), context);
+			return visit_IndexNode(static_cast<IndexNode *>(root), context);
 		}
 		else if (typeid(*root) == typeid(AttrNode))
 		{
-			return visit_AttrNode(static_pointer_cast<AttrNode>(root), context);
+			return visit_AttrNode(static_cast<AttrNode *>(root), context);
 		}
 		else if (typeid(*root) == typeid(BinOpNode))
 		{
-			return visit_BinOpNode(static_pointer_cast<BinOpNode>(root), context);
+			return visit_BinOpNode(static_cast<BinOpNode *>(root), context);
 		}
 		else if (typeid(*root) == typeid(UnaryOpNode))
 		{
-			return visit_UnaryOpNode(static_pointer_cast<UnaryOpNode>(root), context);
+			return visit_UnaryOpNode(static_cast<UnaryOpNode *>(root), context);
 		}
 		else if (typeid(*root) == typeid(VarAccessNode))
 		{
-			return visit_VarAccessNode(static_pointer_cast<VarAccessNode>(root), context, byRef);
+			return visit_VarAccessNode(static_cast<VarAccessNode *>(root), context, byRef);
 		}
 		else if (typeid(*root) == typeid(VarReferenceNode))
 		{
-			return visit(static_pointer_cast<VarReferenceNode>(root)->get_variable(), context, true);
+			return visit(static_cast<VarReferenceNode *>(root)->get_variable(), context, true);
 		}
 		else if (typeid(*root) == typeid(VarAssignNode))
 		{
-			return visit_VarAssignNode(static_pointer_cast<VarAssignNode>(root), context);
+			return visit_VarAssignNode(static_cast<VarAssignNode *>(root), context);
 		}
 		else if (typeid(*root) == typeid(VarDeleteNode))
 		{
-			return visit_VarDeleteNode(static_pointer_cast<VarDeleteNode>(root), context);
+			return visit_VarDeleteNode(static_cast<VarDeleteNode *>(root), context);
 		}
 		else if (typeid(*root) == typeid(DefineNode))
 		{
-			return visit_DefineNode(static_pointer_cast<DefineNode>(root), context);
+			return visit_DefineNode(static_cast<DefineNode *>(root), context);
 		}
 		else if (typeid(*root) == typeid(MutateNode))
 		{
-			return visit_MutateNode(static_pointer_cast<MutateNode>(root), context);
+			return visit_MutateNode(static_cast<MutateNode *>(root), context);
 		}
 		else if (typeid(*root) == typeid(IfNode))
 		{
-			return visit_IfNode(static_pointer_cast<IfNode>(root), context);
+			return visit_IfNode(static_cast<IfNode *>(root), context);
 		}
 		else if (typeid(*root) == typeid(ForNode))
 		{
-			return visit_ForNode(static_pointer_cast<ForNode>(root), context);
+			return visit_ForNode(static_cast<ForNode *>(root), context);
 		}
 		else if (typeid(*root) == typeid(WhileNode))
 		{
-			return visit_WhileNode(static_pointer_cast<WhileNode>(root), context);
+			return visit_WhileNode(static_cast<WhileNode *>(root), context);
 		}
 		else if (typeid(*root) == typeid(FuncDefNode))
 		{
-			return visit_FuncDefNode(static_pointer_cast<FuncDefNode>(root), context);
+			return visit_FuncDefNode(static_cast<FuncDefNode *>(root), context);
 		}
 		else if (typeid(*root) == typeid(CallNode))
 		{
-			return visit_CallNode(static_pointer_cast<CallNode>(root), context);
+			return visit_CallNode(static_cast<CallNode *>(root), context);
 		}
 		else if (typeid(*root) == typeid(ReturnNode))
 		{
-			return visit_ReturnNode(static_pointer_cast<ReturnNode>(root), context);
+			return visit_ReturnNode(static_cast<ReturnNode *>(root), context);
 		}
 		else if (typeid(*root) == typeid(BreakNode))
 		{
-			return visit_BreakNode(static_pointer_cast<BreakNode>(root), context);
+			return visit_BreakNode(static_cast<BreakNode *>(root), context);
 		}
 		else if (typeid(*root) == typeid(ContinueNode))
 		{
-			return visit_ContinueNode(static_pointer_cast<ContinueNode>(root), context);
+			return visit_ContinueNode(static_cast<ContinueNode *>(root), context);
 		}
 		else
 		{
@@ -106,30 +114,57 @@ namespace Basic
 		}
 	}
 
-	RuntimeResult Interpreter::visit_NumberNode(const shared_ptr<NumberNode> &root, Context &context)
+	RuntimeResult Interpreter::visit_NumberNode(NumberNode *root, Context &context)
 	{
 		RuntimeResult res;
+		if (root->get_constant() != nullptr)
+		{
+			DataPtr num = (**root->get_constant())->clone();
+			(*num)->set_context(&context);
+			return res.success(num);
+		}
+
 		Number num(root->get_tok().get_number(), root->pos_start, root->pos_end);
 		num.set_context(&context);
 
 		return res.success(make_Dataptr<Number>(num));
 	}
 
-	RuntimeResult Interpreter::visit_StringNode(const shared_ptr<StringNode> &root, Context &context)
+	RuntimeResult Interpreter::visit_StringNode(StringNode *root, Context &context)
 	{
 		RuntimeResult res;
+		// 拷贝常量池中的值只共享字符串内容，不复制文本
+		if (root->get_constant() != nullptr)
+		{
+			DataPtr str = (**root->get_constant())->clone();
+			(*str)->set_context(&context);
+			return res.success(str);
+		}
 
-		String str(root->get_tok().value);
+		String str(string(root->get_tok().value));
 		str.set_pos(root->pos_start, root->pos_end);
 		str.set_context(&context);
 
 		return res.success(make_Dataptr<String>(str));
 	}
 
-	RuntimeResult Interpreter::visit_ListNode(const shared_ptr<ListNode> &root, Context &context)
+	RuntimeResult Interpreter::visit_ListNode(ListNode *root, Context &context)
 	{
 		RuntimeResult res;
+		if (root->is_return_null())
+		{
+			for (auto const &elem_node : root->get_element_nodes())
+			{
+				res.registry(visit(elem_node, context));
+				if (res.should_return())
+					return res;
+			}
+
+			return res.success(make_Dataptr<Data>());
+		}
+
 		vector<DataPtr> elements;
+		elements.reserve(root->get_element_nodes().size());
 
 		for (auto const &elem_node : root->get_element_nodes())
 		{
@@ -148,10 +183,11 @@ namespace Basic
 		return res.success(make_Dataptr<List>(result));
 	}
 
-	RuntimeResult Interpreter::visit_DictNode(const shared_ptr<DictNode> &root, Context &context)
+	RuntimeResult Interpreter::visit_DictNode(DictNode *root, Context &context)
 	{
 		RuntimeResult res;
-		map<string, DataPtr> elements;
+		DictTable elements;
+		elements.reserve(root->get_elements().size());
 
 		for (auto const &elem_pair : root->get_elements())
 		{
@@ -162,27 +198,56 @@ namespace Basic
 			elements[elem_pair.first] = elem;
 		}
 
-		Dict result(elements);
+		Dict result(std::move(elements));
 		result.set_context(&context);
 		result.set_pos(root->pos_start, root->pos_end);
 
 		return res.success(make_Dataptr<Dict>(result));
 	}
 
-	RuntimeResult Interpreter::visit_BinOpNode(const shared_ptr<BinOpNode> &root, Context &context)
+	// 右操作数为字面量时直接取自常量池，不再分配；只有数字与字符串的运算可以使用
+	// 它们的运算总是生成新值，只读取右操作数的值与位置，不会修改、保存它或使用它的上下文
+	// 常量池中的值被多次求值共享，因此不设置上下文
+	static DataPtr pooled_operand(ASTNode *node)
+	{
+		ConstantPtr constant = nullptr;
+		if (typeid(*node) == typeid(NumberNode))
+			constant = static_cast<NumberNode *>(node)->get_constant();
+		else if (typeid(*node) == typeid(StringNode))
+			constant = static_cast<StringNode *>(node)->get_constant();
+
+		if (constant == nullptr)
+			return nullptr;
+
+		return *constant;
+	}
+
+	RuntimeResult Interpreter::visit_BinOpNode(BinOpNode *root, Context &context)
 	{
 		RuntimeResult res;
 
-		const shared_ptr<ASTNode> &left_node = root->get_left();
-		const shared_ptr<ASTNode> &right_node = root->get_right();
+		ASTNode *left_node = root->get_left();
+		ASTNode *right_node = root->get_right();
 
 		DataPtr left = res.registry(visit(left_node, context));
 		if (res.should_return())
 			return res;
 
-		DataPtr right = res.registry(visit(right_node, context));
-		if (res.should_return())
-			return res;
+		// 列表、字典的运算会把右操作数存入结果，此时不能共享常量池中的值
+		// 类型不同时（如 3 * "x"）运算会转交给右操作数，结果由它派生，同样不能共享
+		DataPtr right;
+		if (typeid(**left) == typeid(Number) || typeid(**left) == typeid(String))
+		{
+			right = pooled_operand(right_node);
+			if (right != nullptr && typeid(**right) != typeid(**left))
+				right = nullptr;
+		}
+		if (right == nullptr)
+		{
+			right = res.registry(visit(right_node, context));
+			if (res.should_return())
+				return res;
+		}
 
 		DataPtr result;
 		try
@@ -231,16 +296,17 @@ namespace Basic
 			{
 				result = (*left)->get_comparison_gte(right);
 			}
-			else if (root->get_op().matches(TD_KEYWORD, "AND"))
+			else if (root->get_op().matches(KW_AND))
 			{
 				result = (*left)->anded_by(right);
 			}
-			else if (root->get_op().matches(TD_KEYWORD, "OR"))
+			else if (root->get_op().matches(KW_OR))
 			{
 				result = (*left)->ored_by(right);
 			}
 
 			(*result)->set_pos(root->pos_start, root->pos_end);
+			(*result)->set_context(&context);
 			return res.success(result);
 		}
 		catch (RunTimeError &e)
@@ -249,7 +315,7 @@ namespace Basic
 		}
 	}
 
-	RuntimeResult Interpreter::visit_UnaryOpNode(const shared_ptr<UnaryOpNode> &root, Context &context)
+	RuntimeResult Interpreter::visit_UnaryOpNode(UnaryOpNode *root, Context &context)
 	{
 		RuntimeResult res;
 		DataPtr num = res.registry(visit(root->get_node(), context));
@@ -258,7 +324,7 @@ namespace Basic
 
 		if (root->get_op().type == TD_MINUS)
 			num = (*num)->multed_by(make_Dataptr<Number>(-1));
-		else if (root->get_op().matches(TD_KEYWORD, "NOT"))
+		else if (root->get_op().matches(KW_NOT))
 			num = (*num)->notted();
 
 		(*num)->set_pos(root->pos_start, root->pos_end);
@@ -266,10 +332,10 @@ namespace Basic
 		return res.success(num);
 	}
 
-	RuntimeResult Interpreter::visit_VarAccessNode(const shared_ptr<VarAccessNode> &root, Context &context, bool byRef)
+	RuntimeResult Interpreter::visit_VarAccessNode(VarAccessNode *root, Context &context, bool byRef)
 	{
 		RuntimeResult res;
-		string var_name = root->get_var_name_tok().value;
+		string var_name(root->get_var_name_tok().value);
 		DataPtr value = context.get_symbol_table().get(var_name);
 
 		if (value == nullptr)
@@ -293,17 +359,17 @@ namespace Basic
 		return res.success(value);
 	}
 
-	RuntimeResult Interpreter::visit_VarDeleteNode(const shared_ptr<VarDeleteNode> &root, Context &context)
+	RuntimeResult Interpreter::visit_VarDeleteNode(VarDeleteNode *root, Context &context)
 	{
 		RuntimeResult res;
 
 		// 对于Token是否为Identifier的检查在Parser中做过了
-		const vector<Token> &var_tok = root->get_deletion();
+		const ArenaList<Token> &var_tok = root->get_deletion();
 		SymbolTable &symbols = context.get_symbol_table();
 
 		for (auto const &tok : var_tok)
 		{
-			string var_name = tok.value;
+			string var_name(tok.value);
 			if (auto value = symbols.get(var_name))
 			{
 				if (typeid(**value) == typeid(BuiltInFunction))
@@ -322,12 +388,12 @@ namespace Basic
 		return res.success(make_Dataptr<Data>());
 	}
 
-	RuntimeResult Interpreter::visit_MutateNode(const shared_ptr<MutateNode> &root, Context &context)
+	RuntimeResult Interpreter::visit_MutateNode(MutateNode *root, Context &context)
 	{
 		RuntimeResult res;
 
-		const shared_ptr<ASTNode> &mutant_node = root->get_mutant();
-		const shared_ptr<ASTNode> &value_node = root->get_value();
+		ASTNode *mutant_node = root->get_mutant();
+		ASTNode *value_node = root->get_value();
 
 		DataPtr mutant = res.registry(visit(mutant_node, context, true));
 		if (res.should_return())
@@ -345,10 +411,10 @@ namespace Basic
 		return res.success(mutant);
 	}
 
-	RuntimeResult Interpreter::visit_DefineNode(const shared_ptr<DefineNode> &root, Context &context)
+	RuntimeResult Interpreter::visit_DefineNode(DefineNode *root, Context &context)
 	{
 		RuntimeResult res;
-		string var_name = root->get_var_name_tok().value;
+		string var_name(root->get_var_name_tok().value);
 		SymbolTable &symbols = context.get_symbol_table();
 
 		if (auto cur_val = symbols.get(var_name); cur_val && typeid(**cur_val) == typeid(BuiltInFunction))
@@ -365,10 +431,10 @@ namespace Basic
 		return res.success(value);
 	}
 
-	RuntimeResult Interpreter::visit_VarAssignNode(const shared_ptr<VarAssignNode> &root, Context &context)
+	RuntimeResult Interpreter::visit_VarAssignNode(VarAssignNode *root, Context &context)
 	{
 		RuntimeResult res;
-		const vector<shared_ptr<ASTNode>> &assignments = root->get_assignments();
+		const ArenaList<ASTNode *> &assignments = root->get_assignments();
 		vector<DataPtr> result;
 
 		for (auto const &ptr : assignments)
@@ -384,7 +450,7 @@ namespace Basic
 			return res.success(make_Dataptr<List>(result));
 	}
 
-	RuntimeResult Interpreter::visit_IndexNode(const shared_ptr<IndexNode> &root, Context &context)
+	RuntimeResult Interpreter::visit_IndexNode(IndexNode *root, Context &context)
 	{
 		RuntimeResult res;
 		DataPtr value = res.registry(visit(root->get_value(), context, true));
@@ -406,11 +472,10 @@ namespace Basic
 		}
 	}
 
-	RuntimeResult Interpreter::visit_AttrNode(const shared_ptr<AttrNode> &root, Context &context)
+	RuntimeResult Interpreter::visit_AttrNode(AttrNode *root, Context &context)
 	{
 		RuntimeResult res;
 
-		const shared_ptr<ASTNode> &elem_node = root->get_elem();
 		const Token &attr_tok = root->get_attr();
 
 		DataPtr elem = res.registry(visit(root->get_elem(), context));
@@ -431,15 +496,15 @@ namespace Basic
 		}
 	}
 
-	RuntimeResult Interpreter::visit_IfNode(const shared_ptr<IfNode> &root, Context &context)
+	RuntimeResult Interpreter::visit_IfNode(IfNode *root, Context &context)
 	{
 		RuntimeResult res;
 
 		for (auto &elem : root->get_cases())
 		{
-			const shared_ptr<ASTNode> &condition_node = std::get<0>(elem);
-			const shared_ptr<ASTNode> &expr_node = std::get<1>(elem);
-			bool should_return_null = std::get<2>(elem);
+			ASTNode *condition_node = elem.condition;
+			ASTNode *expr_node = elem.expr;
+			bool should_return_null = elem.return_null;
 
 			DataPtr condition = res.registry(visit(condition_node, context));
 			Number *condition_value = raw_Dataptr<Number>(condition);
@@ -460,14 +525,14 @@ namespace Basic
 		}
 
 		Else_Case &else_case = root->get_else_case();
-		const shared_ptr<ASTNode> &else_node = std::get<0>(else_case);
+		ASTNode *else_node = else_case.expr;
 		if (else_node != nullptr)
 		{
 			DataPtr else_value = res.registry(visit(else_node, context));
 			if (res.should_return())
 				return res;
 
-			if (std::get<1>(else_case))
+			if (else_case.return_null)
 				return res.success(make_Dataptr<Data>());
 			else
 				return res.success(else_value);
@@ -476,50 +541,50 @@ namespace Basic
 		return res.success(make_Dataptr<Data>());
 	}
 
-	RuntimeResult Interpreter::visit_ForNode(const shared_ptr<ForNode> &root, Context &context)
+	RuntimeResult Interpreter::visit_ForNode(ForNode *root, Context &context)
 	{
 		RuntimeResult res;
 		vector<DataPtr> elements;
 
-		DataPtr start = res.registry(visit(root->get_start_value_node(), context));
-		if (res.should_return())
-			return res;
-		Number *start_data = raw_Dataptr<Number>(start);
-
-		DataPtr end = res.registry(visit(root->get_end_value_node(), context));
-		if (res.should_return())
-			return res;
-		Number *end_data = raw_Dataptr<Number>(end);
-
-		const shared_ptr<ASTNode> &step_node = root->get_step_value_node();
-
-		int i = start_data->get_value(true);
-		int end_value = end_data->get_value(true);
-
-		int step_value = 1;
-		if (step_node != nullptr)
+		// 起点、终点、步长，与字节码的FOR_PREP一致地取整为64位整数
+		ASTNode *bound_nodes[3] = {root->get_start_value_node(), root->get_end_value_node(), root->get_step_value_node()};
+		int64_t bounds[3] = {0, 0, 1};
+		for (int k = 0; k < 3; k++)
 		{
-			DataPtr step = res.registry(visit(step_node, context));
+			if (bound_nodes[k] == nullptr)
+				continue;
+
+			DataPtr bound = res.registry(visit(bound_nodes[k], context));
 			if (res.should_return())
 				return res;
-			Number *step_data = raw_Dataptr<Number>(step);
-			step_value = step_data->get_value();
+			if (typeid(**bound) != typeid(Number))
+				return res.failure(make_shared<RunTimeError>((*bound)->pos_start, (*bound)->pos_end, "Expect a Number", context));
+
+			if (!loop_bound(raw_Dataptr<Number>(bound)->get_value(), bounds[k]))
+				return res.failure(make_shared<RunTimeError>((*bound)->pos_start, (*bound)->pos_end, "Loop bound out of range", context));
 		}
 
-		std::function<bool(int, int)> f;
+		int64_t i = bounds[0];
+		int64_t end_value = bounds[1];
+		int64_t step_value = bounds[2];
+		bool ascending = step_value >= 0; // 步长可以是负的
 
-		// 步长可以是负的
-		if (step_value >= 0)
-			f = [=](int a, int b)
-			{ return a <= b; };
-		else
-			f = [=](int a, int b)
-			{ return a >= b; };
+		if (!root->is_return_null())
+			elements.reserve(loop_count(i, end_value, step_value));
 
-		while (f(i, end_value))
+		// 循环变量在每次循环中原地更新，只有被改为其他值或被引用时才重新分配
+		SymbolTable &table = context.get_symbol_table();
+		string var_name(root->get_var_name_tok().value);
+
+		bool done = false; // 计数器再前进会溢出
+		while (!done && (ascending ? i <= end_value : i >= end_value))
 		{
-			context.get_symbol_table().set(root->get_var_name_tok().value, make_Dataptr<Number>(i));
-			i += step_value;
+			DataPtr *cell = table.find(var_name);
+			if (cell != nullptr)
+				Number::assign(*cell, i);
+			else
+				table.set(var_name, make_Dataptr<Number>(i));
+			done = !loop_advance(i, step_value);
 
 			DataPtr elem = res.registry(visit(root->get_body_node(), context));
 			if (res.should_return() && !res.should_break() && !res.should_continue())
@@ -531,7 +596,7 @@ namespace Basic
 			if (res.should_break())
 				break;
 
-			if (typeid(**elem) != typeid(Data))
+			if (!root->is_return_null() && typeid(**elem) != typeid(Data))
 				elements.push_back(elem);
 		}
 
@@ -546,7 +611,7 @@ namespace Basic
 		}
 	}
 
-	RuntimeResult Interpreter::visit_WhileNode(const shared_ptr<WhileNode> &root, Context &context)
+	RuntimeResult Interpreter::visit_WhileNode(WhileNode *root, Context &context)
 	{
 		RuntimeResult res;
 		vector<DataPtr> elements;
@@ -562,7 +627,7 @@ namespace Basic
 				break;
 
 			DataPtr elem = res.registry(visit(root->get_body_node(), context));
-			if (res.hasError())
+			if (res.should_return() && !res.should_break() && !res.should_continue())
 				return res;
 
 			if (res.should_continue())
@@ -571,7 +636,7 @@ namespace Basic
 			if (res.should_break())
 				break;
 
-			if (typeid(**elem) != typeid(Data))
+			if (!root->is_return_null() && typeid(**elem) != typeid(Data))
 				elements.push_back(elem);
 		}
 
@@ -591,20 +656,22 @@ namespace Basic
 		}
 	}
 
-	RuntimeResult Interpreter::visit_FuncDefNode(const shared_ptr<FuncDefNode> &root, Context &context)
+	RuntimeResult Interpreter::visit_FuncDefNode(FuncDefNode *root, Context &context)
 	{
 		RuntimeResult res;
 
-		string func_name = root->get_var_name_tok().value;
-		const shared_ptr<ASTNode> &body_node = root->get_body_node();
+		string func_name(root->get_var_name_tok().value);
+		ASTNode *body_node = root->get_body_node();
 
 		vector<string> arg_names;
 		for (const Token &tok : root->get_arg_name_toks())
 		{
-			arg_names.push_back(tok.value);
+			arg_names.push_back(string(tok.value));
 		}
 
-		DataPtr func = make_Dataptr<Function>(func_name, body_node, arg_names, root->is_auto_return());
+		// 与虚拟机相同，函数中的变量按定义处而非调用处查找
+		shared_ptr<Environment> closure = make_shared<Environment>(nullptr, nullptr, context.get_shared_symbol_table());
+		DataPtr func = make_Dataptr<Function>(func_name, body_node, this->arena, arg_names, root->is_auto_return(), nullptr, closure);
 		(*func)->set_pos(root->pos_start, root->pos_end);
 
 		if (!root->isAnonymous())
@@ -616,7 +683,7 @@ namespace Basic
 		return res.success(func);
 	}
 
-	RuntimeResult Interpreter::visit_CallNode(const shared_ptr<CallNode> &root, Context &context)
+	RuntimeResult Interpreter::visit_CallNode(CallNode *root, Context &context)
 	{
 		RuntimeResult res;
 		vector<DataPtr> args;
@@ -634,6 +701,10 @@ namespace Basic
 				return res;
 		}
 
+		// 尾调用交由当前函数的Function::execute接着执行，内置函数照常调用
+		if (root->is_tail() && typeid(**value_to_call) == typeid(Function))
+			return res.success_tail_call(value_to_call, std::move(args));
+
 		DataPtr return_value = res.registry((*value_to_call)->execute(args));
 		if (res.should_return())
 			return res;
@@ -644,11 +715,11 @@ namespace Basic
 		return res.success(return_value);
 	}
 
-	RuntimeResult Interpreter::visit_ReturnNode(const shared_ptr<ReturnNode> &root, Context &context)
+	RuntimeResult Interpreter::visit_ReturnNode(ReturnNode *root, Context &context)
 	{
 		RuntimeResult res;
 
-		const shared_ptr<ASTNode> &return_node = root->get_return_node();
+		ASTNode *return_node = root->get_return_node();
 		DataPtr return_value;
 		if (return_node != nullptr)
 		{
@@ -662,12 +733,12 @@ namespace Basic
 		return res.success_return(return_value);
 	}
 
-	RuntimeResult Interpreter::visit_BreakNode(const shared_ptr<BreakNode> &root, Context &context)
+	RuntimeResult Interpreter::visit_BreakNode(BreakNode *root, Context &context)
 	{
 		return RuntimeResult().success_break();
 	}
 
-	RuntimeResult Interpreter::visit_ContinueNode(const shared_ptr<ContinueNode> &root, Context &context)
+	RuntimeResult Interpreter::visit_ContinueNode(ContinueNode *root, Context &context)
 	{
 		return RuntimeResult().success_continue();
 	}
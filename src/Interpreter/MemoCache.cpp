@@ -0,0 +1,148 @@
+#include "Interpreter/MemoCache.h"
+#include "Interpreter/Data.h"
+#include <algorithm>
+
+namespace Basic
+{
+	// 长度等以定长字节写入，避免"ab"+"c"与"a"+"bc"得到相同的键
+	static void append_size(size_t n, string &key)
+	{
+		uint64_t value = n;
+		key.append(reinterpret_cast<const char *>(&value), sizeof(value));
+	}
+
+	MemoCache::MemoCache(size_t capacity)
+	{
+		this->capacity = capacity;
+	}
+
+	bool MemoCache::make_key(const vector<DataPtr> &args, string &key)
+	{
+		key.clear();
+		append_size(args.size(), key);
+		for (const DataPtr &arg : args)
+		{
+			if (!append_key(arg->get(), key))
+				return false;
+		}
+
+		return true;
+	}
+
+	bool MemoCache::append_key(Data *value, string &key)
+	{
+		if (typeid(*value) == typeid(Number))
+		{
+			// -0与0视为同一个数
+			double number = static_cast<Number *>(value)->get_value();
+			if (number == 0)
+				number = 0;
+
+			key.push_back('n');
+			key.append(reinterpret_cast<const char *>(&number), sizeof(number));
+		}
+		else if (typeid(*value) == typeid(String))
+		{
+			const string &text = static_cast<String *>(value)->getValue();
+			key.push_back('s');
+			append_size(text.size(), key);
+			key.append(text);
+		}
+		else if (typeid(*value) == typeid(List))
+		{
+			List *list = static_cast<List *>(value);
+			key.push_back('l');
+			append_size(list->size(), key);
+			for (const DataPtr &elem : *list)
+			{
+				if (!append_key(elem->get(), key))
+					return false;
+			}
+		}
+		else if (typeid(*value) == typeid(Dict))
+		{
+			// 键的插入顺序不影响相等，按键排序后编码
+			const DictTable &table = static_cast<Dict *>(value)->get_table();
+			vector<const DictTable::Entry *> entries;
+			entries.reserve(table.size());
+			for (const DictTable::Entry &entry : table)
+				entries.push_back(&entry);
+			std::sort(entries.begin(), entries.end(), [](const DictTable::Entry *a, const DictTable::Entry *b)
+					  { return a->key < b->key; });
+
+			key.push_back('d');
+			append_size(entries.size(), key);
+			for (const DictTable::Entry *entry : entries)
+			{
+				append_size(entry->key.size(), key);
+				key.append(entry->key);
+				if (!append_key(entry->value->get(), key))
+					return false;
+			}
+		}
+		else if (typeid(*value) == typeid(Data))
+		{
+			key.push_back('u');
+		}
+		else
+		{
+			return false;
+		}
+
+		return true;
+	}
+
+	DataPtr MemoCache::get(const string &key)
+	{
+		auto found = index.find(key);
+		if (found == index.end())
+		{
+			misses++;
+			return nullptr;
+		}
+
+		hits++;
+		entries.splice(entries.begin(), entries, found->second);
+		return found->second->value;
+	}
+
+	void MemoCache::put(const string &key, const DataPtr &value)
+	{
+		auto found = index.find(key);
+		if (found != index.end())
+		{
+			found->second->value = value;
+			entries.splice(entries.begin(), entries, found->second);
+			return;
+		}
+
+		if (entries.size() >= capacity)
+		{
+			index.erase(entries.back().key);
+			entries.pop_back();
+		}
+
+		entries.push_front(Entry{key, value});
+		index.emplace(entries.front().key, entries.begin());
+	}
+
+	size_t MemoCache::size() const
+	{
+		return entries.size();
+	}
+
+	size_t MemoCache::get_capacity() const
+	{
+		return capacity;
+	}
+
+	uint64_t MemoCache::get_hits() const
+	{
+		return hits;
+	}
+
+	uint64_t MemoCache::get_misses() const
+	{
+		return misses;
+	}
+}
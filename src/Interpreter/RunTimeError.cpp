@@ -5,31 +5,65 @@ namespace Basic
 
 	RunTimeError::RunTimeError(const Position &start, const Position &end, const string &details, Context &context) : Error(start, end, "Runtime Error", details)
 	{
-		this->context = context;
+		Position pos = this->pos_start;
+		Context *ctx = &context;
+
+		while (ctx != nullptr)
+		{
+			this->traceback.push_back(make_pair(ctx->get_displayName(), pos));
+			pos = ctx->get_parent_entry_pos();
+			ctx = ctx->get_parent();
+		}
 	}
 
 	string RunTimeError::as_string()
 	{
 		string result = generate_traceback();
 		result += this->error_name + ": " + this->details;
-		result += "\n\n\n" + string_with_arrows(pos_start.fileContent, pos_start, pos_end);
+		result += "\n\n\n" + string_with_arrows(pos_start, pos_end);
 
 		return result;
 	}
 
+	// 深层递归时同一位置会重复成千上万次，只输出前几次
+	static const size_t MAX_REPEATS = 3;
+
+	static string repeated_line(size_t repeats)
+	{
+		if (repeats < MAX_REPEATS)
+			return "";
+
+		size_t omitted = repeats - MAX_REPEATS + 1;
+		return "  [Previous line repeated " + std::to_string(omitted) + (omitted == 1 ? " more time]\n" : " more times]\n");
+	}
+
 	string RunTimeError::generate_traceback()
 	{
-		string result = "";
-		Position pos = this->pos_start;
-		shared_ptr<Context> ctx = make_shared<Context>(this->context);
+		string result = "Traceback (most recent call last):\n";
 
-		while (ctx != nullptr)
+		const pair<string, Position> *last = nullptr;
+		size_t repeats = 0;
+
+		for (auto it = this->traceback.rbegin(); it != this->traceback.rend(); ++it)
 		{
-			result = "  File " + pos.fileName + ", line " + std::to_string(pos.row + 1) + ", in " + ctx->get_displayName() + "\n" + result;
-			pos = ctx->get_parent_entry_pos();
-			ctx = ctx->get_parent();
+			const Position &pos = it->second;
+			if (last != nullptr && last->first == it->first && last->second.file_id == pos.file_id && last->second.row == pos.row)
+			{
+				if (++repeats >= MAX_REPEATS)
+					continue;
+			}
+			else
+			{
+				result += repeated_line(repeats);
+				repeats = 0;
+			}
+
+			result += "  File " + pos.fileName() + ", line " + std::to_string(pos.row + 1) + ", in " + it->first + "\n";
+			last = &*it;
 		}
 
-		return "Traceback (most recent call last):\n" + result;
+		result += repeated_line(repeats);
+
+		return result;
 	}
-}
\ No newline at end of file
+}
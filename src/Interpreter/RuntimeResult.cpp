@@ -16,6 +16,7 @@ namespace Basic
 		this->value = other.value;
 		this->error = other.error;
 		this->func_return_value = other.func_return_value;
+		this->tail_call = other.tail_call;
 		this->loop_continue = other.loop_continue;
 		this->loop_break = other.loop_break;
 	}
@@ -23,6 +24,7 @@ namespace Basic
 	void RuntimeResult::reset()
 	{
 		this->func_return_value.reset();
+		this->tail_call.reset();
 		this->value.reset();
 		this->error.reset();
 		this->loop_break = false;
@@ -33,6 +35,7 @@ namespace Basic
 	{
 		this->error = res.error;
 		this->func_return_value = res.func_return_value;
+		this->tail_call = res.tail_call;
 		this->loop_break = res.loop_break;
 		this->loop_continue = res.loop_continue;
 
@@ -43,6 +46,7 @@ namespace Basic
 	{
 		this->error = move(res.error);
 		this->func_return_value = move(res.func_return_value);
+		this->tail_call = move(res.tail_call);
 		this->loop_break = res.loop_break;
 		this->loop_continue = res.loop_continue;
 
@@ -91,6 +95,13 @@ namespace Basic
 		return (*this);
 	}
 
+	RuntimeResult RuntimeResult::success_tail_call(const shared_ptr<unique_ptr<Data>> &callee, vector<shared_ptr<unique_ptr<Data>>> &&args)
+	{
+		reset();
+		this->tail_call = std::make_shared<TailCall>(TailCall{callee, std::move(args)});
+		return (*this);
+	}
+
 	RuntimeResult RuntimeResult::success_continue()
 	{
 		reset();
@@ -112,7 +123,7 @@ namespace Basic
 
 	bool RuntimeResult::should_return()
 	{
-		return (error != nullptr || func_return_value != nullptr || loop_continue || loop_break);
+		return (error != nullptr || func_return_value != nullptr || tail_call != nullptr || loop_continue || loop_break);
 	}
 
 	const shared_ptr<unique_ptr<Data>> &RuntimeResult::getValuePtr()
@@ -130,6 +141,11 @@ namespace Basic
 		return this->func_return_value;
 	}
 
+	const shared_ptr<TailCall> &RuntimeResult::get_tail_call()
+	{
+		return this->tail_call;
+	}
+
 	bool RuntimeResult::should_continue()
 	{
 		return this->loop_continue;
@@ -0,0 +1,61 @@
+#include "Interpreter/Stats.h"
+
+namespace Basic
+{
+	uint64_t Stats::allocations[static_cast<size_t>(DataKind::COUNT)] = {};
+	uint64_t Stats::clones = 0;
+	uint64_t Stats::lookup_hits[LOOKUP_DEPTHS] = {};
+	uint64_t Stats::lookup_misses[LOOKUP_DEPTHS] = {};
+	uint64_t Stats::function_calls = 0;
+	uint64_t Stats::builtin_calls = 0;
+	int64_t Stats::live = 0;
+	int64_t Stats::peak_live = 0;
+
+	const char *Stats::kind_name(DataKind kind)
+	{
+		switch (kind)
+		{
+		case DataKind::DATA:
+			return "Undefined";
+		case DataKind::NUMBER:
+			return "Number";
+		case DataKind::STRING:
+			return "String";
+		case DataKind::LIST:
+			return "List";
+		case DataKind::DICT:
+			return "Dict";
+		case DataKind::FUNCTION:
+			return "Function";
+		case DataKind::BUILTIN:
+			return "BuiltInFunction";
+		default:
+			return "?";
+		}
+	}
+
+	void Stats::dump(std::ostream &os)
+	{
+		os << "\n---- Stats ----\n";
+
+		os << "allocated:";
+		for (size_t i = 0; i < static_cast<size_t>(DataKind::COUNT); i++)
+			os << " " << kind_name(static_cast<DataKind>(i)) << "=" << allocations[i];
+		os << "\n";
+
+		os << "clones: " << clones << "\n";
+		os << "live values: " << live << " (peak " << peak_live << ")\n";
+		os << "calls: function=" << function_calls << " builtin=" << builtin_calls << "\n";
+
+		// 深度为向上查找的层数，最后一列包含更深的层数
+		os << "lookup hits by depth:";
+		for (size_t i = 0; i < LOOKUP_DEPTHS; i++)
+			os << " " << lookup_hits[i];
+		os << "\n";
+
+		os << "lookup misses by depth:";
+		for (size_t i = 0; i < LOOKUP_DEPTHS; i++)
+			os << " " << lookup_misses[i];
+		os << "\n";
+	}
+}
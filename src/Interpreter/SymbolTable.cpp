@@ -23,17 +23,35 @@ namespace Basic
 
 	shared_ptr<unique_ptr<Data>> SymbolTable::get(const string &name)
 	{
-		auto result = symbols.find(name);
-		if (result != symbols.end())
-			return result->second;
-		else if (parent != nullptr)
+		// 逐层向上查找，同时统计查找的层数
+		size_t depth = 0;
+		for (SymbolTable *table = this; table != nullptr; table = table->parent.get(), depth++)
 		{
-			return (*parent).get(name);
+			auto result = table->symbols.find(name);
+			if (result != table->symbols.end())
+			{
+				Stats::lookup_hit(depth);
+				return result->second;
+			}
 		}
 
+		Stats::lookup_miss(depth - 1);
 		return nullptr;
 	}
 
+	shared_ptr<unique_ptr<Data>> *SymbolTable::find(const string &name)
+	{
+		auto result = symbols.find(name);
+		if (result == symbols.end())
+		{
+			Stats::lookup_miss(0);
+			return nullptr;
+		}
+
+		Stats::lookup_hit(0);
+		return &result->second;
+	}
+
 	void SymbolTable::remove(const string &symbol)
 	{
 		symbols.erase(symbol);
@@ -1,15 +1,13 @@
 #include "Common/utils.h"
 #include "Lexer/Lexer.h"
-#include <map>
-using std::map;
 
 namespace Basic
 {
 	Lexer::Lexer(const string &filename, const string &text)
 	{
-		this->filename = filename;
-		this->text = text;
-		this->pos = Position(-1, 0, -1, filename, text);
+		uint32_t file_id = SourceRegistry::add(filename, text);
+		this->text = SourceRegistry::get_content(file_id);
+		this->pos = Position(-1, 0, -1, file_id);
 		this->current_char = '\0';
 		advance();
 	}
@@ -23,14 +21,36 @@ namespace Basic
 			this->current_char = '\0';
 	}
 
+	size_t Lexer::advance_run(uint8_t char_class)
+	{
+		size_t start = this->pos.index;
+		size_t end = start;
+		while (end < this->text.length() && char_is(this->text[end], char_class))
+			end++;
+
+		advance_by(end - start);
+		return end - start;
+	}
+
+	void Lexer::advance_by(size_t count)
+	{
+		if (count == 0)
+			return;
+
+		// 跳过的字符中不含换行，行号不变
+		this->pos.index += count;
+		this->pos.column += count;
+		this->current_char = (size_t)this->pos.index < this->text.length() ? this->text[this->pos.index] : '\0';
+	}
+
 	void Lexer::skip_comment()
 	{
 		advance(); // 跳过#
 
-		while (!Basic::isIn(NEWLINE, current_char)) // 不是换行或分号，一直步进
-		{
-			advance();
-		}
+		// 不是换行或分号，一直步进
+		// strcspn在多数libc中有向量化实现
+		if (this->current_char != '\0')
+			advance_by(std::strcspn(this->text.data() + this->pos.index, "\n;"));
 
 		advance(); // 跳过换行
 	}
@@ -40,13 +60,13 @@ namespace Basic
 		vector<Token> tokens;
 		while (this->current_char != '\0')
 		{
-			if (Basic::isIn(IGNORES, current_char))
-				advance();
+			if (char_is(current_char, CC_IGNORE))
+				advance_run(CC_IGNORE);
 			else if (this->current_char == '#') // 注释
 			{
 				skip_comment();
 			}
-			else if (Basic::isIn(NEWLINE, current_char))
+			else if (char_is(current_char, CC_NEWLINE))
 			{
 				tokens.push_back(Token(TD_NEWLINE, 0, this->pos));
 				advance();
@@ -56,15 +76,15 @@ namespace Basic
 				tokens.push_back(Token(TD_COLON, 0, this->pos));
 				advance();
 			}
-			else if (Basic::isLetter(current_char))
+			else if (char_is(current_char, CC_LETTER))
 			{
 				tokens.push_back(make_identifier());
 			}
-			else if (Basic::isIn(SIGNS, current_char))
+			else if (char_is(current_char, CC_SIGN))
 			{
 				tokens.push_back(make_sign());
 			}
-			else if (Basic::isIn(DIGITS, current_char))
+			else if (char_is(current_char, CC_DIGIT))
 			{
 				tokens.push_back(make_number());
 			}
@@ -185,11 +205,16 @@ namespace Basic
 		string num_str = "";
 		bool hasDot = false, hasSci = false;
 		Position start = this->pos;
-		vector<char> scientific{'.', 'e', 'E', '+', '-'};
 
-		while (this->current_char != '\0' && (Basic::isIn(DIGITS, current_char) || isIn(scientific, this->current_char)))
+		while (char_is(this->current_char, CC_NUMBER))
 		{
-			if (this->current_char == '.')
+			if (char_is(this->current_char, CC_DIGIT))
+			{
+				size_t start_index = this->pos.index;
+				num_str.append(this->text, start_index, advance_run(CC_DIGIT));
+				continue;
+			}
+			else if (this->current_char == '.')
 			{
 				// 不能有两个小数点，所以遇到第二个退出
 				if (hasDot)
@@ -215,67 +240,79 @@ namespace Basic
 
 	Token Lexer::make_identifier()
 	{
-		string identifier;
 		Position start = this->pos;
+		size_t length = advance_run(CC_IDENT);
+		string_view identifier = this->text.substr(start.index, length);
+
+		Keyword keyword = find_keyword(identifier.data(), identifier.size());
+		if (keyword != KW_NONE)
+			return Token(keyword, start, this->pos);
 
-		while (!(this->current_char == '\0') && (Basic::isLetter(current_char) || Basic::isIn(DIGITS, current_char) || current_char == '_'))
+		return Token(TD_IDENTIFIER, identifier, start, this->pos);
+	}
+
+	// 处理转义：如果\后面是n，则应为\n（换行），t为制表符，其余字符原样保留
+	static string unescape(string_view raw)
+	{
+		string str;
+		bool escape = false;
+
+		for (char ch : raw)
 		{
-			identifier.push_back(current_char);
-			advance();
+			if (escape)
+			{
+				if (ch == 'n')
+					str.push_back('\n');
+				else if (ch == 't')
+					str.push_back('\t');
+				else
+					str.push_back(ch);
+				escape = false;
+			}
+			else if (ch == '\\')
+				escape = true;
+			else
+				str.push_back(ch);
 		}
 
-		string tok_type = TD_IDENTIFIER;
-		if (Basic::isIn(KEYWORDS, identifier))
-			tok_type = TD_KEYWORD;
-
-		return Token(tok_type, identifier, start, this->pos);
+		return str;
 	}
 
 	Token Lexer::make_string()
 	{
-		string str;
 		Position start = this->pos;
 		advance();
 
 		// 处理形如：str = "abc:\"xxx\""
 		// 读取到\后的下一个字符需要无条件读入
-		// 我们需要处理，如果\后面是n，则应为\n（换行）等情况
-		bool escape = false; // 当遇到'\\'，设为true，意为接收下一个字符
-		map<char, char> escape_characters{
-			std::pair<char, char>('n', '\n'),
-			std::pair<char, char>('t', '\t')}; // 上一个字符是\\，则下一个n应被转换为\n；以此类推
+		size_t begin = this->pos.index;
+		bool escape = false;	 // 当遇到'\\'，设为true，意为接收下一个字符
+		bool has_escape = false; // 没有转义时可以直接引用源码
 
 		while (current_char != '\0' && (current_char != '\"' || escape))
 		{
 			if (escape)
-			{
-				if (escape_characters.find(current_char) != escape_characters.end())
-					str.push_back(escape_characters[current_char]);
-				else
-					str.push_back(current_char);
 				escape = false;
-			}
-			else
-			{
-				if (current_char == '\\')
-					escape = true;
-				else
-					str.push_back(current_char);
-			}
+			else if (current_char == '\\')
+				escape = has_escape = true;
 			advance();
 		}
 
 		if (current_char != '\"')
 			throw ExpectCharError(start, this->pos, "'\"' at the end of a string");
 
+		string_view str = this->text.substr(begin, this->pos.index - begin);
 		advance();
 
+		if (has_escape)
+			str = SourceRegistry::keep(unescape(str));
+
 		return Token(TD_STRING, str, start, this->pos);
 	}
 
 	Token Lexer::make_minus_or_arrow()
 	{
-		string tok_type = TD_MINUS;
+		TokenType tok_type = TD_MINUS;
 		Position start = this->pos;
 		advance();
 
@@ -308,7 +345,7 @@ namespace Basic
 	Token Lexer::make_equals()
 	{
 		Position start = this->pos;
-		string tok_type = TD_EQ;
+		TokenType tok_type = TD_EQ;
 		advance();
 
 		if (this->current_char == '=')
@@ -323,7 +360,7 @@ namespace Basic
 	Token Lexer::make_less_than()
 	{
 		Position start = this->pos;
-		string tok_type = TD_LT;
+		TokenType tok_type = TD_LT;
 		advance();
 
 		if (this->current_char == '=')
@@ -338,7 +375,7 @@ namespace Basic
 	Token Lexer::make_greater_than()
 	{
 		Position start = this->pos;
-		string tok_type = TD_GT;
+		TokenType tok_type = TD_GT;
 		advance();
 
 		if (this->current_char == '=')
@@ -2,30 +2,23 @@
 
 namespace Basic
 {
-	Token::Token(const string &type_, const string &value_, const Position &start, const Position &end)
+	Token::Token(TokenType type_, string_view value_, const Position &start, const Position &end)
+		: Token(type_, 0.0, start, end)
 	{
-		this->type = type_;
 		this->value = value_;
+	}
 
-		if (start.index != -1)
-		{
-			this->pos_start = start;
-			this->pos_end = start;
-			this->pos_end.advance();
-		}
-
-		if (end.index != -1)
-			this->pos_end = end;
+	Token::Token(Keyword keyword_, const Position &start, const Position &end)
+		: Token(TD_KEYWORD, 0.0, start, end)
+	{
+		this->keyword = keyword_;
 	}
 
-	Token::Token(const string &type_, double value_, const Position &start, const Position &end)
+	Token::Token(TokenType type_, double value_, const Position &start, const Position &end)
 	{
 		this->type = type_;
-
-		if (value_ == 0 && type_ != TD_INT)
-			this->value = "0";
-		else
-			this->value = std::to_string(value_);
+		this->keyword = KW_NONE;
+		this->number = value_;
 
 		if (start.index != -1)
 		{
@@ -38,58 +31,43 @@ namespace Basic
 			this->pos_end = end;
 	}
 
-	Token::Token(const Token &other)
-	{
-		this->type = other.type;
-		this->value = other.value;
-		this->pos_start = other.pos_start;
-		this->pos_end = other.pos_end;
-	}
-
 	bool Token::operator==(const Token &other) const
 	{
-		if (this->type != other.type)
+		if (this->type != other.type || this->keyword != other.keyword)
 			return false;
-		if (this->value != other.value)
+		if (this->number != other.number || this->value != other.value)
 			return false;
 
 		return true;
 	}
 
-	bool Token::matches(const string &_type, const string &_value)
-	{
-		if (this->type == _type && this->value == _value)
-			return true;
-
-		return false;
-	}
-
 	void Token::set_pos(const Position &start, const Position &end)
 	{
 		this->pos_start = start;
 		this->pos_end = end;
 	}
 
-	double Token::get_number()
+	double Token::get_number() const
 	{
-		if (type == TD_INT)
-			return atoi(value.c_str());
-		else if (type == TD_FLOAT)
-			return atof(value.c_str());
+		if (type == TD_INT || type == TD_FLOAT)
+			return number;
 
 		return -1;
 	}
 
-	string Token::repr()
+	string Token::repr() const
 	{
-		if (this->value == "0" && this->type != TD_INT)
-			return this->type;
+		string type_name = TOKEN_TYPE_NAMES[this->type];
 
 		if (this->type == TD_INT)
-			return this->type + ":" + std::to_string(atoi(this->value.c_str()));
+			return type_name + ":" + std::to_string((long long)this->number);
 		else if (this->type == TD_FLOAT)
-			return this->type + ":" + std::to_string(atof(this->value.c_str()));
+			return type_name + ":" + std::to_string(this->number);
+		else if (this->type == TD_KEYWORD)
+			return type_name + ":" + KEYWORDS[this->keyword];
+		else if (this->type == TD_IDENTIFIER || this->type == TD_STRING)
+			return type_name + ":" + string(this->value);
 		else
-			return this->type + ":" + this->value;
+			return type_name;
 	}
 }
\ No newline at end of file
@@ -0,0 +1,37 @@
+#include "Parser/AstArena.h"
+
+namespace Basic
+{
+	static const size_t BLOCK_SIZE = 64 * 1024;
+
+	size_t AstArena::bytes_used() const
+	{
+		return used;
+	}
+
+	void *AstArena::allocate(size_t size, size_t align)
+	{
+		uintptr_t start = (reinterpret_cast<uintptr_t>(cursor) + align - 1) & ~(uintptr_t)(align - 1);
+
+		if (cursor == nullptr || start + size > reinterpret_cast<uintptr_t>(limit))
+		{
+			// 过大的数组单独占用一块，不浪费当前块剩余的空间
+			if (size > BLOCK_SIZE / 4)
+			{
+				blocks.emplace_back(new char[size]);
+				used += size;
+				return blocks.back().get();
+			}
+
+			blocks.emplace_back(new char[BLOCK_SIZE]);
+			cursor = blocks.back().get();
+			limit = cursor + BLOCK_SIZE;
+			start = reinterpret_cast<uintptr_t>(cursor);
+		}
+
+		char *result = reinterpret_cast<char *>(start);
+		used += result + size - cursor;
+		cursor = result + size;
+		return result;
+	}
+}
@@ -21,6 +21,16 @@ namespace Basic
 		return this->tok;
 	}
 
+	ConstantPtr NumberNode::get_constant()
+	{
+		return this->constant;
+	}
+
+	void NumberNode::set_constant(ConstantPtr constant)
+	{
+		this->constant = constant;
+	}
+
 	StringNode::StringNode(const Token &tok)
 	{
 		this->tok = tok;
@@ -39,7 +49,17 @@ namespace Basic
 		return this->tok;
 	}
 
-	BinOpNode::BinOpNode(const shared_ptr<ASTNode> &_left, const Token &_op, const shared_ptr<ASTNode> &_right)
+	ConstantPtr StringNode::get_constant()
+	{
+		return this->constant;
+	}
+
+	void StringNode::set_constant(ConstantPtr constant)
+	{
+		this->constant = constant;
+	}
+
+	BinOpNode::BinOpNode(ASTNode *_left, const Token &_op, ASTNode *_right)
 	{
 		this->left = _left;
 		this->op = _op;
@@ -54,12 +74,12 @@ namespace Basic
 		return Basic::format("(%s, %s, %s)", left->repr().c_str(), op.repr().c_str(), right->repr().c_str());
 	}
 
-	const shared_ptr<ASTNode> &BinOpNode::get_left()
+	ASTNode *&BinOpNode::get_left()
 	{
 		return this->left;
 	}
 
-	const shared_ptr<ASTNode> &BinOpNode::get_right()
+	ASTNode *&BinOpNode::get_right()
 	{
 		return this->right;
 	}
@@ -69,7 +89,7 @@ namespace Basic
 		return this->op;
 	}
 
-	UnaryOpNode::UnaryOpNode(const Token &_op, const shared_ptr<ASTNode> &_node)
+	UnaryOpNode::UnaryOpNode(const Token &_op, ASTNode *_node)
 	{
 		this->op = _op;
 		this->node = _node;
@@ -88,7 +108,7 @@ namespace Basic
 		return this->op;
 	}
 
-	const shared_ptr<ASTNode> &UnaryOpNode::get_node()
+	ASTNode *&UnaryOpNode::get_node()
 	{
 		return this->node;
 	}
@@ -110,7 +130,7 @@ namespace Basic
 		return this->var_name_tok;
 	}
 
-	VarReferenceNode::VarReferenceNode(const shared_ptr<ASTNode> &var)
+	VarReferenceNode::VarReferenceNode(ASTNode *var)
 	{
 		this->variable = var;
 		this->pos_start = var->pos_start;
@@ -122,12 +142,12 @@ namespace Basic
 		return "&" + this->variable->repr();
 	}
 
-	const shared_ptr<ASTNode> &VarReferenceNode::get_variable()
+	ASTNode *&VarReferenceNode::get_variable()
 	{
 		return this->variable;
 	}
 
-	MutateNode::MutateNode(const shared_ptr<ASTNode> &mutant, const shared_ptr<ASTNode> &value)
+	MutateNode::MutateNode(ASTNode *mutant, ASTNode *value)
 	{
 		this->mutant = mutant;
 		this->value = value;
@@ -141,17 +161,17 @@ namespace Basic
 		return Basic::format("%s = %s", mutant->repr().c_str(), value->repr().c_str());
 	}
 
-	const shared_ptr<ASTNode> &MutateNode::get_mutant()
+	ASTNode *&MutateNode::get_mutant()
 	{
 		return this->mutant;
 	}
 
-	const shared_ptr<ASTNode> &MutateNode::get_value()
+	ASTNode *&MutateNode::get_value()
 	{
 		return this->value;
 	}
 
-	DefineNode::DefineNode(const Token &var_name_tok, const shared_ptr<ASTNode> &value_node)
+	DefineNode::DefineNode(const Token &var_name_tok, ASTNode *value_node)
 	{
 		this->var_name_tok = var_name_tok;
 		this->value_node = value_node;
@@ -172,12 +192,12 @@ namespace Basic
 		return this->var_name_tok;
 	}
 
-	const shared_ptr<ASTNode> &DefineNode::get_value_node()
+	ASTNode *&DefineNode::get_value_node()
 	{
 		return this->value_node;
 	}
 
-	VarAssignNode::VarAssignNode(const vector<shared_ptr<ASTNode>>& assignments, const Position& start, const Position& end)
+	VarAssignNode::VarAssignNode(const ArenaList<ASTNode *> &assignments, const Position &start, const Position &end)
 	{
 		this->assignments = assignments;
 		this->pos_start = start;
@@ -199,12 +219,12 @@ namespace Basic
 		return result;
 	}
 
-	const vector<shared_ptr<ASTNode>>& VarAssignNode::get_assignments()
+	const ArenaList<ASTNode *> &VarAssignNode::get_assignments()
 	{
 		return this->assignments;
 	}
 
-	VarDeleteNode::VarDeleteNode(const vector<Token>& deletion, const Position& start, const Position& end)
+	VarDeleteNode::VarDeleteNode(const ArenaList<Token> &deletion, const Position &start, const Position &end)
 	{
 		this->deletion = deletion;
 		this->pos_start = start;
@@ -224,7 +244,7 @@ namespace Basic
 		return result;
 	}
 
-	const vector<Token>& VarDeleteNode::get_deletion()
+	const ArenaList<Token> &VarDeleteNode::get_deletion()
 	{
 		return this->deletion;
 	}
@@ -236,16 +256,16 @@ namespace Basic
 
 		if (!_cases.empty())
 		{
-			this->pos_start = std::get<0>(_cases[0])->pos_start;
+			this->pos_start = _cases[0].condition->pos_start;
 
-			shared_ptr<ASTNode> else_node = std::get<0>(_else_case);
+			ASTNode *else_node = _else_case.expr;
 			if (else_node != nullptr)
 			{
 				this->pos_end = else_node->pos_end;
 			}
 			else
 			{
-				this->pos_end = std::get<0>(_cases.back())->pos_end;
+				this->pos_end = _cases.back().condition->pos_end;
 			}
 		}
 	}
@@ -257,13 +277,13 @@ namespace Basic
 		for (auto &elem : cases)
 		{
 			result += "IF ";
-			result += std::get<0>(elem)->repr();
+			result += elem.condition->repr();
 			result += " THEN ";
-			result += std::get<1>(elem)->repr();
+			result += elem.expr->repr();
 			result += " ";
 		}
 
-		shared_ptr<ASTNode> else_node = std::get<0>(else_case);
+		ASTNode *else_node = else_case.expr;
 		if (else_node != nullptr)
 		{
 			result += "ELSE ";
@@ -283,7 +303,7 @@ namespace Basic
 		return this->else_case;
 	}
 
-	ForNode::ForNode(const Token &var_name, const shared_ptr<ASTNode> &start_value_node, const shared_ptr<ASTNode> &end_value_node, const shared_ptr<ASTNode> &body_node, const shared_ptr<ASTNode> &step_value_node, bool return_null)
+	ForNode::ForNode(const Token &var_name, ASTNode *start_value_node, ASTNode *end_value_node, ASTNode *body_node, ASTNode *step_value_node, bool return_null)
 	{
 		this->var_name_tok = var_name;
 		this->start_value_node = start_value_node;
@@ -318,22 +338,22 @@ namespace Basic
 		return this->var_name_tok;
 	}
 
-	const shared_ptr<ASTNode> &ForNode::get_start_value_node()
+	ASTNode *&ForNode::get_start_value_node()
 	{
 		return this->start_value_node;
 	}
 
-	const shared_ptr<ASTNode> &ForNode::get_end_value_node()
+	ASTNode *&ForNode::get_end_value_node()
 	{
 		return this->end_value_node;
 	}
 
-	const shared_ptr<ASTNode> &ForNode::get_body_node()
+	ASTNode *&ForNode::get_body_node()
 	{
 		return this->body_node;
 	}
 
-	const shared_ptr<ASTNode> &ForNode::get_step_value_node()
+	ASTNode *&ForNode::get_step_value_node()
 	{
 		return this->step_value_node;
 	}
@@ -343,7 +363,12 @@ namespace Basic
 		return this->return_null;
 	}
 
-	WhileNode::WhileNode(const shared_ptr<ASTNode> &condition, const shared_ptr<ASTNode> &body_node, bool return_null)
+	void ForNode::set_return_null(bool return_null)
+	{
+		this->return_null = return_null;
+	}
+
+	WhileNode::WhileNode(ASTNode *condition, ASTNode *body_node, bool return_null)
 	{
 		this->condition_node = condition;
 		this->body_node = body_node;
@@ -358,12 +383,12 @@ namespace Basic
 		return Basic::format("WHILE %s THEN %s", condition_node->repr().c_str(), body_node->repr().c_str());
 	}
 
-	const shared_ptr<ASTNode> &WhileNode::get_condition_node()
+	ASTNode *&WhileNode::get_condition_node()
 	{
 		return this->condition_node;
 	}
 
-	const shared_ptr<ASTNode> &WhileNode::get_body_node()
+	ASTNode *&WhileNode::get_body_node()
 	{
 		return this->body_node;
 	}
@@ -373,7 +398,12 @@ namespace Basic
 		return this->return_null;
 	}
 
-	FuncDefNode::FuncDefNode(const Token &var_name, const vector<Token> &arg_name_toks, const shared_ptr<ASTNode> &body_node, bool anonymous, bool auto_return)
+	void WhileNode::set_return_null(bool return_null)
+	{
+		this->return_null = return_null;
+	}
+
+	FuncDefNode::FuncDefNode(const Token &var_name, const ArenaList<Token> &arg_name_toks, ASTNode *body_node, bool anonymous, bool auto_return)
 	{
 		this->var_name_tok = var_name;
 		this->arg_name_toks = arg_name_toks;
@@ -425,12 +455,12 @@ namespace Basic
 		return this->var_name_tok;
 	}
 
-	const vector<Token> &FuncDefNode::get_arg_name_toks()
+	const ArenaList<Token> &FuncDefNode::get_arg_name_toks()
 	{
 		return this->arg_name_toks;
 	}
 
-	const shared_ptr<ASTNode> &FuncDefNode::get_body_node()
+	ASTNode *&FuncDefNode::get_body_node()
 	{
 		return this->body_node;
 	}
@@ -445,7 +475,7 @@ namespace Basic
 		return this->auto_return;
 	}
 
-	CallNode::CallNode(const shared_ptr<ASTNode> &node_to_call, const vector<shared_ptr<ASTNode>> &arg_nodes)
+	CallNode::CallNode(ASTNode *node_to_call, const ArenaList<ASTNode *> &arg_nodes)
 	{
 		this->func = node_to_call;
 		this->args = arg_nodes;
@@ -479,28 +509,48 @@ namespace Basic
 		return result;
 	}
 
-	const shared_ptr<ASTNode> &CallNode::get_func_node()
+	ASTNode *&CallNode::get_func_node()
 	{
 		return this->func;
 	}
 
-	const vector<shared_ptr<ASTNode>> &CallNode::get_args_nodes()
+	const ArenaList<ASTNode *> &CallNode::get_args_nodes()
 	{
 		return this->args;
 	}
 
-	ListNode::ListNode(const vector<shared_ptr<ASTNode>> &elem_nodes, const Position &start, const Position &end)
+	bool CallNode::is_tail()
+	{
+		return this->tail;
+	}
+
+	void CallNode::set_tail(bool tail)
+	{
+		this->tail = tail;
+	}
+
+	ListNode::ListNode(const ArenaList<ASTNode *> &elem_nodes, const Position &start, const Position &end)
 	{
 		this->element_nodes = elem_nodes;
 		this->pos_start = start;
 		this->pos_end = end;
 	}
 
-	const vector<shared_ptr<ASTNode>> &ListNode::get_element_nodes()
+	const ArenaList<ASTNode *> &ListNode::get_element_nodes()
 	{
 		return this->element_nodes;
 	}
 
+	bool ListNode::is_return_null()
+	{
+		return this->return_null;
+	}
+
+	void ListNode::set_return_null(bool return_null)
+	{
+		this->return_null = return_null;
+	}
+
 	string ListNode::repr()
 	{
 		string result = "[";
@@ -517,14 +567,14 @@ namespace Basic
 		return result;
 	}
 
-	DictNode::DictNode(const map<string, shared_ptr<ASTNode>> &elem, const Position &start, const Position &end)
+	DictNode::DictNode(const ArenaList<pair<string_view, ASTNode *>> &elem, const Position &start, const Position &end)
 	{
 		this->elements = elem;
 		this->pos_start = start;
 		this->pos_end = end;
 	}
 
-	const map<string, shared_ptr<ASTNode>> &DictNode::get_elements()
+	const ArenaList<pair<string_view, ASTNode *>> &DictNode::get_elements()
 	{
 		return this->elements;
 	}
@@ -547,7 +597,7 @@ namespace Basic
 		return result;
 	}
 
-	IndexNode::IndexNode(const shared_ptr<ASTNode> &value, const shared_ptr<ASTNode> &index)
+	IndexNode::IndexNode(ASTNode *value, ASTNode *index)
 	{
 		this->value = value;
 		this->index = index;
@@ -556,12 +606,12 @@ namespace Basic
 		this->pos_end = index->pos_end;
 	}
 
-	const shared_ptr<ASTNode> &IndexNode::get_value()
+	ASTNode *&IndexNode::get_value()
 	{
 		return this->value;
 	}
 
-	const shared_ptr<ASTNode> &IndexNode::get_index()
+	ASTNode *&IndexNode::get_index()
 	{
 		return this->index;
 	}
@@ -571,7 +621,7 @@ namespace Basic
 		return Basic::format("%s[%s]", value->repr().c_str(), index->repr().c_str());
 	}
 
-	AttrNode::AttrNode(const shared_ptr<ASTNode> &elem, const Token &attr)
+	AttrNode::AttrNode(ASTNode *elem, const Token &attr)
 	{
 		this->elem = elem;
 		this->attr = attr;
@@ -580,7 +630,7 @@ namespace Basic
 		this->pos_end = attr.pos_end;
 	}
 
-	const shared_ptr<ASTNode> &AttrNode::get_elem()
+	ASTNode *&AttrNode::get_elem()
 	{
 		return this->elem;
 	}
@@ -595,7 +645,7 @@ namespace Basic
 		return this->elem->repr() + "." + this->attr.repr();
 	}
 
-	ReturnNode::ReturnNode(const shared_ptr<ASTNode> &node_to_return, const Position &start, const Position &end)
+	ReturnNode::ReturnNode(ASTNode *node_to_return, const Position &start, const Position &end)
 	{
 		this->node_to_return = node_to_return;
 		this->pos_start = start;
@@ -607,7 +657,7 @@ namespace Basic
 		return Basic::format("RETURN %s", node_to_return->repr().c_str());
 	}
 
-	const shared_ptr<ASTNode> &ReturnNode::get_return_node()
+	ASTNode *&ReturnNode::get_return_node()
 	{
 		return this->node_to_return;
 	}
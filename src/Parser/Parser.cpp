@@ -3,1106 +3,792 @@
 #include "Parser/InvalidSyntaxError.h"
 
 using std::make_shared;
-using std::make_tuple;
 
 namespace Basic
 {
-	Parser::Parser(const vector<Token> &toks)
+	// 二元运算符的优先级，数值越大结合越紧
+	// 幂运算右结合，且右侧允许一元运算，单独在power中处理
+	enum Precedence : int
 	{
-		this->tokens = toks;
-		this->tok_idx = -1;
-		advance();
+		PREC_NONE,	  // 不是二元运算符
+		PREC_LOGIC,	  // AND OR
+		PREC_COMPARE, // == != < > <= >=
+		PREC_ARITH,	  // + -
+		PREC_TERM,	  // * /
+	};
+
+	static int precedence(const Token &tok)
+	{
+		switch (tok.type)
+		{
+		case TD_EE:
+		case TD_NE:
+		case TD_LT:
+		case TD_GT:
+		case TD_LTE:
+		case TD_GTE:
+			return PREC_COMPARE;
+		case TD_PLUS:
+		case TD_MINUS:
+			return PREC_ARITH;
+		case TD_MUL:
+		case TD_DIV:
+			return PREC_TERM;
+		case TD_KEYWORD:
+			return (tok.keyword == KW_AND || tok.keyword == KW_OR) ? PREC_LOGIC : PREC_NONE;
+		default:
+			return PREC_NONE;
+		}
+	}
+
+	// 能否作为comp_expr的开头
+	static bool starts_operand(const Token &tok)
+	{
+		switch (tok.type)
+		{
+		case TD_INT:
+		case TD_FLOAT:
+		case TD_STRING:
+		case TD_IDENTIFIER:
+		case TD_PLUS:
+		case TD_MINUS:
+		case TD_LPAREN:
+		case TD_LSQUARE:
+		case TD_LBRACE:
+		case TD_REF:
+			return true;
+		case TD_KEYWORD:
+			return isIn({KW_NOT, KW_IF, KW_FOR, KW_WHILE, KW_FUNC}, tok.keyword);
+		default:
+			return false;
+		}
+	}
+
+	// 能否作为expr的开头
+	static bool starts_expr(const Token &tok)
+	{
+		return tok.matches(KW_VAR) || starts_operand(tok);
+	}
+
+	// 能否作为statement的开头
+	static bool starts_statement(const Token &tok)
+	{
+		if (isIn({KW_RETURN, KW_DEL, KW_BREAK, KW_CONTINUE}, tok.keyword))
+			return true;
+		return starts_expr(tok);
+	}
+
+	Parser::Parser(vector<Token> &&toks)
+	{
+		this->arena = make_shared<AstArena>();
+		this->tokens = std::move(toks);
+		this->tok_idx = 0;
+		this->current_tok = &tokens[0];
 	}
 
 	void Parser::advance()
 	{
-		this->tok_idx++;
-		if (tok_idx < tokens.size())
-			current_tok = tokens[tok_idx];
+		// 停留在EOF上
+		if (tok_idx + 1 < tokens.size())
+			current_tok = &tokens[++tok_idx];
 	}
 
-	void Parser::reverse(int amount)
+	void Parser::error(const string &details) const
 	{
-		this->tok_idx -= amount;
-		if (tok_idx >= 0 && tok_idx < tokens.size())
-			current_tok = tokens[tok_idx];
+		throw InvalidSyntaxError(current_tok->pos_start, current_tok->pos_end, details);
 	}
 
-	Parse_Result Parser::parse()
+	bool Parser::skip_newlines_before(Keyword a, Keyword b)
 	{
-		Parse_Result res = statements();
+		size_t idx = tok_idx;
+		while (tokens[idx].type == TD_NEWLINE)
+			idx++;
 
-		// 若解析未出错，但依旧没有到达EOF，说明存在SyntaxError
-		if (!res.hasError() && this->current_tok.type != TD_EOF)
-		{
-			return res.failure(make_shared<InvalidSyntaxError>(this->current_tok.pos_start, this->current_tok.pos_end, "Expected '+', '-', '*', '/', '^', '==', '!=', '<', '>', '<=', '>=', 'AND' or 'OR'"));
-		}
+		if (!tokens[idx].matches(a) && !tokens[idx].matches(b))
+			return false;
 
-		return res;
+		tok_idx = idx;
+		current_tok = &tokens[idx];
+		return true;
 	}
 
-	Parse_Result Parser::func_def()
+	const shared_ptr<AstArena> &Parser::get_arena() const
 	{
-		Parse_Result res;
+		return this->arena;
+	}
 
-		if (!current_tok.matches(TD_KEYWORD, "FUNC"))
-		{
-			return res.failure(make_shared<InvalidSyntaxError>(this->current_tok.pos_start, this->current_tok.pos_end, "Expected 'FUNC'"));
-		}
+	ASTNode *Parser::parse()
+	{
+		ASTNode *node = statements();
+
+		// 若解析未出错，但依旧没有到达EOF，说明存在SyntaxError
+		if (this->current_tok->type != TD_EOF)
+			error("Expected '+', '-', '*', '/', '^', '==', '!=', '<', '>', '<=', '>=', 'AND' or 'OR'");
+
+		return node;
+	}
+
+	ASTNode *Parser::func_def()
+	{
+		if (!current_tok->matches(KW_FUNC))
+			error("Expected 'FUNC'");
 
-		res.registry_advancement();
 		advance();
 
 		bool anonymous = false;
 		Token var_name(TD_IDENTIFIER, "<anonymous>");
-		if (current_tok.type == TD_IDENTIFIER)
+		if (current_tok->type == TD_IDENTIFIER)
 		{
-			var_name = current_tok;
-			res.registry_advancement();
+			var_name = *current_tok;
 			advance();
 
-			if (current_tok.type != TD_LPAREN)
-			{
-				return res.failure(make_shared<InvalidSyntaxError>(this->current_tok.pos_start, this->current_tok.pos_end, "Expected '('"));
-			}
+			if (current_tok->type != TD_LPAREN)
+				error("Expected '('");
 		}
 		else
 		{
 			anonymous = true;
-			if (current_tok.type != TD_LPAREN)
-			{
-				return res.failure(make_shared<InvalidSyntaxError>(this->current_tok.pos_start, this->current_tok.pos_end, "Expected identifier or '('"));
-			}
+			if (current_tok->type != TD_LPAREN)
+				error("Expected identifier or '('");
 		}
 
-		res.registry_advancement();
 		advance();
 
 		vector<Token> arg_name_toks;
 
 		// 有参数
-		if (current_tok.type == TD_IDENTIFIER)
+		if (current_tok->type == TD_IDENTIFIER)
 		{
-			arg_name_toks.push_back(current_tok);
-			res.registry_advancement();
+			arg_name_toks.push_back(*current_tok);
 			advance();
 
-			while (current_tok.type == TD_COMMA)
+			while (current_tok->type == TD_COMMA)
 			{
-				res.registry_advancement();
 				advance();
 
-				if (current_tok.type != TD_IDENTIFIER)
-				{
-					return res.failure(make_shared<InvalidSyntaxError>(this->current_tok.pos_start, this->current_tok.pos_end, "Expected identifier"));
-				}
+				if (current_tok->type != TD_IDENTIFIER)
+					error("Expected identifier");
 
-				arg_name_toks.push_back(current_tok);
-				res.registry_advancement();
+				arg_name_toks.push_back(*current_tok);
 				advance();
 			}
 
-			if (current_tok.type != TD_RPAREN)
-			{
-				return res.failure(make_shared<InvalidSyntaxError>(this->current_tok.pos_start, this->current_tok.pos_end, "Expected ',' or ')'"));
-			}
+			if (current_tok->type != TD_RPAREN)
+				error("Expected ',' or ')'");
 		}
 		// 无参数
-		else
+		else if (current_tok->type != TD_RPAREN)
 		{
-			if (current_tok.type != TD_RPAREN)
-			{
-				return res.failure(make_shared<InvalidSyntaxError>(this->current_tok.pos_start, this->current_tok.pos_end, "Expected identifier or ')'"));
-			}
+			error("Expected identifier or ')'");
 		}
 
-		res.registry_advancement();
 		advance();
 
 		// 单行函数定义
-		if (current_tok.type == TD_ARROW)
+		if (current_tok->type == TD_ARROW)
 		{
-			res.registry_advancement();
 			advance();
 
-			shared_ptr<ASTNode> exp = res.registry(statement());
-			if (res.hasError())
-				return res;
-
-			return res.success(make_shared<FuncDefNode>(var_name, arg_name_toks, exp, anonymous, true));
+			ASTNode *exp = statement();
+			return arena->make<FuncDefNode>(var_name, arena->copy(arg_name_toks), exp, anonymous, true);
 		}
 
 		// 多行函数定义
-		if (current_tok.type != TD_COLON && current_tok.type != TD_NEWLINE)
-		{
-			return res.failure(make_shared<InvalidSyntaxError>(this->current_tok.pos_start, this->current_tok.pos_end, "Expected '->' or NEWLINE"));
-		}
-		res.registry_advancement();
+		if (current_tok->type != TD_COLON && current_tok->type != TD_NEWLINE)
+			error("Expected '->' or NEWLINE");
+
 		advance();
 
-		shared_ptr<ASTNode> body = res.registry(statements());
-		if (res.hasError())
-			return res;
+		ASTNode *body = statements();
 
-		if (!current_tok.matches(TD_KEYWORD, "END"))
-		{
-			return res.failure(make_shared<InvalidSyntaxError>(this->current_tok.pos_start, this->current_tok.pos_end, "Expected 'END'"));
-		}
+		if (!current_tok->matches(KW_END))
+			error("Expected 'END'");
 
-		res.registry_advancement();
 		advance();
 
-		return res.success(make_shared<FuncDefNode>(var_name, arg_name_toks, body, anonymous, false));
+		return arena->make<FuncDefNode>(var_name, arena->copy(arg_name_toks), body, anonymous, false);
 	}
 
-	Parse_Result Parser::while_expr()
+	ASTNode *Parser::while_expr()
 	{
-		Parse_Result res;
-
-		if (!current_tok.matches(TD_KEYWORD, "WHILE"))
-		{
-			return res.failure(make_shared<InvalidSyntaxError>(this->current_tok.pos_start, this->current_tok.pos_end, "Expected 'WHILE'"));
-		}
+		if (!current_tok->matches(KW_WHILE))
+			error("Expected 'WHILE'");
 
-		res.registry_advancement();
 		advance();
 
-		shared_ptr<ASTNode> condition = res.registry(expr());
-		if (res.hasError())
-			return res;
+		ASTNode *condition = expr();
 
-		if (!current_tok.matches(TD_KEYWORD, "THEN"))
-		{
-			return res.failure(make_shared<InvalidSyntaxError>(this->current_tok.pos_start, this->current_tok.pos_end, "Expected 'THEN'"));
-		}
+		if (!current_tok->matches(KW_THEN))
+			error("Expected 'THEN'");
 
-		res.registry_advancement();
 		advance();
 
-		// 下面开始获取循环主体(body)
-		shared_ptr<ASTNode> body = nullptr;
 		// 多行情况
-		if (current_tok.type == TD_COLON || current_tok.type == TD_NEWLINE)
+		if (current_tok->type == TD_COLON || current_tok->type == TD_NEWLINE)
 		{
-			res.registry_advancement();
 			advance();
 
-			body = res.registry(statements());
-			if (res.hasError())
-				return res;
+			ASTNode *body = statements();
 
-			if (!current_tok.matches(TD_KEYWORD, "END"))
-			{
-				return res.failure(make_shared<InvalidSyntaxError>(this->current_tok.pos_start, this->current_tok.pos_end, "Expected 'END'"));
-			}
+			if (!current_tok->matches(KW_END))
+				error("Expected 'END'");
 
-			res.registry_advancement();
 			advance();
 
-			return res.success(make_shared<WhileNode>(condition, body, true));
+			return arena->make<WhileNode>(condition, body, true);
 		}
 
 		// 单行情况
-		body = res.registry(statement());
-		if (res.hasError())
-			return res;
-
-		return res.success(make_shared<WhileNode>(condition, body, false));
+		ASTNode *body = statement();
+		return arena->make<WhileNode>(condition, body, false);
 	}
 
-	Parse_Result Parser::for_expr()
+	ASTNode *Parser::for_expr()
 	{
-		Parse_Result res;
-
 		// 先确定循环符合语法
-		if (!current_tok.matches(TD_KEYWORD, "FOR"))
-		{
-			return res.failure(make_shared<InvalidSyntaxError>(this->current_tok.pos_start, this->current_tok.pos_end, "Expected 'FOR'"));
-		}
+		if (!current_tok->matches(KW_FOR))
+			error("Expected 'FOR'");
 
-		res.registry_advancement();
 		advance();
 
-		if (current_tok.type != TD_IDENTIFIER)
-		{
-			return res.failure(make_shared<InvalidSyntaxError>(this->current_tok.pos_start, this->current_tok.pos_end, "Expected identifier"));
-		}
+		if (current_tok->type != TD_IDENTIFIER)
+			error("Expected identifier");
 
-		Token var_name = this->current_tok;
+		const Token &var_name = *this->current_tok;
 
-		res.registry_advancement();
 		advance();
 
-		if (current_tok.type != TD_EQ)
-		{
-			return res.failure(make_shared<InvalidSyntaxError>(this->current_tok.pos_start, this->current_tok.pos_end, "Expected '='"));
-		}
+		if (current_tok->type != TD_EQ)
+			error("Expected '='");
 
-		res.registry_advancement();
 		advance();
 
-		shared_ptr<ASTNode> start_value = res.registry(expr());
-		if (res.hasError())
-			return res;
+		ASTNode *start_value = expr();
 
-		if (!current_tok.matches(TD_KEYWORD, "TO"))
-		{
-			return res.failure(make_shared<InvalidSyntaxError>(this->current_tok.pos_start, this->current_tok.pos_end, "Expected 'TO'"));
-		}
+		if (!current_tok->matches(KW_TO))
+			error("Expected 'TO'");
 
-		res.registry_advancement();
 		advance();
 
-		shared_ptr<ASTNode> end_value = res.registry(expr());
-		if (res.hasError())
-			return res;
+		ASTNode *end_value = expr();
 
 		// 步长设置可选
-		shared_ptr<ASTNode> step_value = nullptr;
-		if (current_tok.matches(TD_KEYWORD, "STEP"))
+		ASTNode *step_value = nullptr;
+		if (current_tok->matches(KW_STEP))
 		{
-			res.registry_advancement();
 			advance();
-
-			step_value = res.registry(expr());
-			if (res.hasError())
-				return res;
+			step_value = expr();
 		}
 
-		if (!current_tok.matches(TD_KEYWORD, "THEN"))
-		{
-			return res.failure(make_shared<InvalidSyntaxError>(this->current_tok.pos_start, this->current_tok.pos_end, "Expected 'THEN'"));
-		}
+		if (!current_tok->matches(KW_THEN))
+			error("Expected 'THEN'");
 
-		res.registry_advancement();
 		advance();
 
-		// 下面开始获取循环主体(body)
-		shared_ptr<ASTNode> body = nullptr;
 		// 多行情况
-		if (current_tok.type == TD_COLON || current_tok.type == TD_NEWLINE)
+		if (current_tok->type == TD_COLON || current_tok->type == TD_NEWLINE)
 		{
-			res.registry_advancement();
 			advance();
 
-			body = res.registry(statements());
-			if (res.hasError())
-				return res;
+			ASTNode *body = statements();
 
-			if (!current_tok.matches(TD_KEYWORD, "END"))
-			{
-				return res.failure(make_shared<InvalidSyntaxError>(this->current_tok.pos_start, this->current_tok.pos_end, "Expected 'END'"));
-			}
+			if (!current_tok->matches(KW_END))
+				error("Expected 'END'");
 
-			res.registry_advancement();
 			advance();
 
-			return res.success(make_shared<ForNode>(var_name, start_value, end_value, body, step_value, true));
+			return arena->make<ForNode>(var_name, start_value, end_value, body, step_value, true);
 		}
 
 		// 单行情况
-		body = res.registry(statement());
-		if (res.hasError())
-			return res;
-		return res.success(make_shared<ForNode>(var_name, start_value, end_value, body, step_value, false));
+		ASTNode *body = statement();
+		return arena->make<ForNode>(var_name, start_value, end_value, body, step_value, false);
 	}
 
-	Parse_Result Parser::if_expr_cases(const string &case_keyword)
+	void Parser::if_expr_cases(Keyword case_keyword, vector<If_Case> &cases, Else_Case &else_case)
 	{
-		Parse_Result res;
-		Cases cases;
-		Else_Case else_case;
-
-		if (!current_tok.matches(TD_KEYWORD, case_keyword))
-		{
-			return res.failure(make_shared<InvalidSyntaxError>(current_tok.pos_start, current_tok.pos_end, "Expected " + case_keyword));
-		}
+		if (!current_tok->matches(case_keyword))
+			error(string("Expected ") + KEYWORDS[case_keyword]);
 
-		res.registry_advancement();
 		advance();
 
-		shared_ptr<ASTNode> condition = res.registry(expr());
-		if (res.hasError())
-			return res;
+		ASTNode *condition = expr();
 
-		if (!current_tok.matches(TD_KEYWORD, "THEN"))
-		{
-			return res.failure(make_shared<InvalidSyntaxError>(current_tok.pos_start, current_tok.pos_end, "Expected 'THEN'"));
-		}
+		if (!current_tok->matches(KW_THEN))
+			error("Expected 'THEN'");
 
-		res.registry_advancement();
 		advance();
 
-		if (current_tok.type == TD_COLON)
+		if (current_tok->type == TD_COLON)
 		{
-			res.registry_advancement();
 			advance();
 
-			shared_ptr<ASTNode> statement_node = res.registry(statements());
-			if (res.hasError())
-				return res;
+			ASTNode *statement_node = statements();
 
 			// 不允许多行表达式作为另一个表达式的一部分
 			// 例如，对于单行表达式可以有
 			// VAR a = IF age<18 THEN "Child" ELSE "Adult"
 			// 但是多行不允许，所以传入一个bool值来使其返回null
-			cases.push_back(std::make_tuple(condition, statement_node, true));
+			cases.push_back({condition, statement_node, true});
 
-			if (current_tok.matches(TD_KEYWORD, "END"))
+			if (current_tok->matches(KW_END))
 			{
-				res.registry_advancement();
 				advance();
-			}
-			else
-			{
-				shared_ptr<ASTNode> all_cases = res.registry(elif_or_else_expr());
-				if (res.hasError())
-					return res;
-
-				shared_ptr<IfNode> all_cases_node = std::static_pointer_cast<IfNode>(all_cases);
-				Cases new_cases = all_cases_node->get_cases();
-				cases.insert(cases.end(), new_cases.begin(), new_cases.end());
-				else_case = all_cases_node->get_else_case();
+				return;
 			}
 		}
 		else
 		{
-			shared_ptr<ASTNode> exp = res.registry(statement());
-			if (res.hasError())
-				return res;
-
-			while (current_tok.type == TD_NEWLINE)
-			{
-				res.registry_advancement();
-				advance();
-			}
-
-			if (!(isIn({"ELSE", "ELIF"}, current_tok.value) || current_tok.type == TD_EOF))
-			{
-				reverse(1);
-			}
+			ASTNode *exp = statement();
 
 			// 单行表达式，可以利用其返回值
-			cases.push_back(std::make_tuple(condition, exp, false));
+			cases.push_back({condition, exp, false});
 
-			shared_ptr<ASTNode> all_cases = res.registry(elif_or_else_expr());
-			if (res.hasError())
-				return res;
-
-			shared_ptr<IfNode> all_cases_node = std::static_pointer_cast<IfNode>(all_cases);
-			Cases new_cases = all_cases_node->get_cases();
-			cases.insert(cases.end(), new_cases.begin(), new_cases.end());
-			else_case = all_cases_node->get_else_case();
+			// ELIF/ELSE可以另起一行；否则换行留给外层的statements
+			skip_newlines_before(KW_ELIF, KW_ELSE);
 		}
 
-		return res.success(make_shared<IfNode>(cases, else_case));
-	}
-
-	Parse_Result Parser::elif_or_else_expr()
-	{
-		Parse_Result res;
-		shared_ptr<IfNode> all_cases_node = nullptr;
-
-		if (current_tok.matches(TD_KEYWORD, "ELIF"))
-		{
-			shared_ptr<ASTNode> all_cases = res.registry(elif_expr());
-			if (res.hasError())
-				return res;
-
-			all_cases_node = std::static_pointer_cast<IfNode>(all_cases);
-		}
+		if (current_tok->matches(KW_ELIF))
+			if_expr_cases(KW_ELIF, cases, else_case);
 		else
-		{
-			shared_ptr<ASTNode> else_case = res.registry(else_expr());
-			if (res.hasError())
-				return res;
-
-			all_cases_node = std::static_pointer_cast<IfNode>(else_case);
-		}
-
-		return res.success(all_cases_node);
+			else_expr(else_case);
 	}
 
-	Parse_Result Parser::else_expr()
+	void Parser::else_expr(Else_Case &else_case)
 	{
-		Parse_Result res;
-		Cases empty;
-		Else_Case else_case;
+		if (!current_tok->matches(KW_ELSE))
+			return;
 
-		if (current_tok.matches(TD_KEYWORD, "ELSE"))
+		advance();
+
+		if (current_tok->type == TD_COLON || current_tok->type == TD_NEWLINE)
 		{
-			res.registry_advancement();
 			advance();
 
-			if (current_tok.type == TD_COLON || current_tok.type == TD_NEWLINE)
-			{
-				res.registry_advancement();
-				advance();
-
-				shared_ptr<ASTNode> statement_node = res.registry(statements());
-				if (res.hasError())
-					return res;
-
-				else_case = make_tuple(statement_node, true);
+			ASTNode *statement_node = statements();
 
-				if (current_tok.matches(TD_KEYWORD, "END"))
-				{
-					res.registry_advancement();
-					advance();
-				}
-				else
-				{
-					return res.failure(make_shared<InvalidSyntaxError>(current_tok.pos_start, current_tok.pos_end, "Expected 'END'"));
-				}
-			}
-			else
-			{
-				shared_ptr<ASTNode> exp = res.registry(statement());
-				if (res.hasError())
-					return res;
+			if (!current_tok->matches(KW_END))
+				error("Expected 'END'");
 
-				while (current_tok.value == ";")
-				{
-					res.registry_advancement();
-					advance();
-				}
+			advance();
 
-				else_case = make_tuple(exp, false);
-			}
+			else_case = {statement_node, true};
+		}
+		else
+		{
+			else_case = {statement(), false};
 		}
-		return res.success(make_shared<IfNode>(empty, else_case));
-	}
-
-	Parse_Result Parser::elif_expr()
-	{
-		return if_expr_cases("ELIF");
 	}
 
-	Parse_Result Parser::if_expr()
+	ASTNode *Parser::if_expr()
 	{
-		Parse_Result res;
-		shared_ptr<ASTNode> all_cases = res.registry(if_expr_cases("IF"));
-		if (res.hasError())
-			return res;
+		vector<If_Case> cases;
+		Else_Case else_case;
+		if_expr_cases(KW_IF, cases, else_case);
 
-		return res.success(all_cases);
+		return arena->make<IfNode>(arena->copy(cases), else_case);
 	}
 
-	Parse_Result Parser::list_expr()
+	ASTNode *Parser::list_expr()
 	{
-		Parse_Result res;
-		vector<shared_ptr<ASTNode>> elem_nodes;
-		Position start = this->current_tok.pos_start;
+		vector<ASTNode *> elem_nodes;
+		Position start = this->current_tok->pos_start;
 
-		if (current_tok.type != TD_LSQUARE)
-		{
-			return res.failure(make_shared<InvalidSyntaxError>(current_tok.pos_start, current_tok.pos_end, "Expected '['"));
-		}
+		if (current_tok->type != TD_LSQUARE)
+			error("Expected '['");
 
-		res.registry_advancement();
 		advance();
 
 		// empty list
-		if (current_tok.type == TD_RSQUARE)
+		if (current_tok->type != TD_RSQUARE)
 		{
-			res.registry_advancement();
-			advance();
-		}
-		else
-		{
-			elem_nodes.push_back(res.registry(expr()));
-			if (res.hasError())
-			{
-				return res.failure(make_shared<InvalidSyntaxError>(current_tok.pos_start, current_tok.pos_end, "Expected ']', 'VAR', 'IF', 'FOR', 'WHILE', 'FUNC', int, float, identifier, '+', '-', '(', '[' or 'NOT'"));
-			}
+			elem_nodes.push_back(expr());
 
-			while (current_tok.type == TD_COMMA)
+			while (current_tok->type == TD_COMMA)
 			{
-				res.registry_advancement();
 				advance();
-
-				elem_nodes.push_back(res.registry(expr()));
-				if (res.hasError())
-					return res;
+				elem_nodes.push_back(expr());
 			}
 
-			if (current_tok.type != TD_RSQUARE)
-			{
-				return res.failure(make_shared<InvalidSyntaxError>(current_tok.pos_start, current_tok.pos_end, "Expected ',' or ']'"));
-			}
-
-			res.registry_advancement();
-			advance();
+			if (current_tok->type != TD_RSQUARE)
+				error("Expected ',' or ']'");
 		}
 
-		return res.success(make_shared<ListNode>(elem_nodes, start, current_tok.pos_end));
+		advance();
+
+		return arena->make<ListNode>(arena->copy(elem_nodes), start, current_tok->pos_end);
 	}
 
-	Parse_Result Parser::dict_expr()
+	ASTNode *Parser::dict_expr()
 	{
-		Parse_Result res;
-		map<string, shared_ptr<ASTNode>> elements;
-		Position start = this->current_tok.pos_start;
+		vector<pair<string_view, ASTNode *>> elements;
+		Position start = this->current_tok->pos_start;
+
+		if (current_tok->type != TD_LBRACE)
+			error("Expected '{'");
 
-		if (current_tok.type != TD_LBRACE)
-		{
-			return res.failure(make_shared<InvalidSyntaxError>(current_tok.pos_start, current_tok.pos_end, "Expected '{'"));
-		}
-		res.registry_advancement();
 		advance();
 
 		// empty dict
-		if (current_tok.type == TD_RBRACE)
+		if (current_tok->type != TD_RBRACE)
 		{
-			res.registry_advancement();
-			advance();
-		}
-		else
-		{
-			reverse(1);
-			do
+			while (true)
 			{
-				// 跳过','（对于第一个键值，先reverse）
-				res.registry_advancement();
+				if (current_tok->type != TD_IDENTIFIER)
+					error("Expected an identifier for Key");
+
+				string_view key = current_tok->value;
 				advance();
 
-				if (current_tok.type != TD_IDENTIFIER)
-				{
-					return res.failure(make_shared<InvalidSyntaxError>(current_tok.pos_start, current_tok.pos_end, "Expected an identifier for Key"));
-				}
+				if (current_tok->type != TD_COLON)
+					error("Expected ':'");
 
-				string key = current_tok.value;
-				res.registry_advancement();
 				advance();
 
-				if (current_tok.type != TD_COLON)
+				ASTNode *value = expr();
+
+				// 重复的键以最后一次为准
+				bool duplicated = false;
+				for (auto &elem : elements)
 				{
-					return res.failure(make_shared<InvalidSyntaxError>(current_tok.pos_start, current_tok.pos_end, "Expected ':'"));
+					if (elem.first == key)
+					{
+						elem.second = value;
+						duplicated = true;
+						break;
+					}
 				}
-				res.registry_advancement();
-				advance();
+				if (!duplicated)
+					elements.push_back({key, value});
 
-				shared_ptr<ASTNode> value = res.registry(expr());
-				if (res.hasError())
-					return res;
+				if (current_tok->type != TD_COMMA)
+					break;
 
-				elements[key] = value;
-			} while (current_tok.type == TD_COMMA);
-
-			if (current_tok.type != TD_RBRACE)
-			{
-				return res.failure(make_shared<InvalidSyntaxError>(current_tok.pos_start, current_tok.pos_end, "Expected ',' or '}'"));
+				advance();
 			}
 
-			res.registry_advancement();
-			advance();
+			if (current_tok->type != TD_RBRACE)
+				error("Expected ',' or '}'");
 		}
 
-		return res.success(make_shared<DictNode>(elements, start, current_tok.pos_end));
+		advance();
+
+		return arena->make<DictNode>(arena->copy(elements), start, current_tok->pos_end);
 	}
 
-	Parse_Result Parser::atom()
+	ASTNode *Parser::atom()
 	{
-		Parse_Result res;
-		Token tok = this->current_tok;
+		const Token &tok = *this->current_tok;
 
-		if (Basic::isIn({TD_INT, TD_FLOAT}, tok.type))
+		switch (tok.type)
 		{
-			res.registry_advancement();
+		case TD_INT:
+		case TD_FLOAT:
 			advance();
-
-			return res.success(make_shared<NumberNode>(tok));
-		}
-		else if (tok.type == TD_STRING)
-		{
-			res.registry_advancement();
+			return arena->make<NumberNode>(tok);
+		case TD_STRING:
 			advance();
-
-			return res.success(make_shared<StringNode>(tok));
-		}
-		else if (tok.type == TD_IDENTIFIER)
-		{
-			res.registry_advancement();
+			return arena->make<StringNode>(tok);
+		case TD_IDENTIFIER:
 			advance();
-			return res.success(make_shared<VarAccessNode>(tok));
-		}
-		else if (tok.type == TD_LPAREN)
+			return arena->make<VarAccessNode>(tok);
+		case TD_LPAREN:
 		{
-			res.registry_advancement();
 			advance();
-			shared_ptr<ASTNode> exp = res.registry(expr());
-			if (res.hasError())
-				return res;
+			ASTNode *exp = expr();
 
-			if (current_tok.type == TD_RPAREN)
-			{
-				res.registry_advancement();
-				advance();
-				return res.success(exp);
-			}
-			else
-				return res.failure(make_shared<InvalidSyntaxError>(current_tok.pos_start, current_tok.pos_end, "Expected ')'"));
-		}
-		else if (tok.type == TD_LSQUARE)
-		{
-			shared_ptr<ASTNode> list_exp = res.registry(list_expr());
-			if (res.hasError())
-				return res;
-			return res.success(list_exp);
-		}
-		else if (tok.type == TD_LBRACE)
-		{
-			shared_ptr<ASTNode> dict_exp = res.registry(dict_expr());
-			if (res.hasError())
-				return res;
-			return res.success(dict_exp);
-		}
-		else if (tok.matches(TD_KEYWORD, "IF"))
-		{
-			shared_ptr<ASTNode> if_exp = res.registry(if_expr());
-			if (res.hasError())
-				return res;
-			return res.success(if_exp);
-		}
-		else if (tok.matches(TD_KEYWORD, "FOR"))
-		{
-			shared_ptr<ASTNode> for_exp = res.registry(for_expr());
-			if (res.hasError())
-				return res;
-			return res.success(for_exp);
-		}
-		else if (tok.matches(TD_KEYWORD, "WHILE"))
-		{
-			shared_ptr<ASTNode> while_exp = res.registry(while_expr());
-			if (res.hasError())
-				return res;
-			return res.success(while_exp);
-		}
-		else if (tok.matches(TD_KEYWORD, "FUNC"))
-		{
-			shared_ptr<ASTNode> func_exp = res.registry(func_def());
-			if (res.hasError())
-				return res;
-			return res.success(func_exp);
+			if (current_tok->type != TD_RPAREN)
+				error("Expected ')'");
+
+			advance();
+			return exp;
+		}
+		case TD_LSQUARE:
+			return list_expr();
+		case TD_LBRACE:
+			return dict_expr();
+		case TD_KEYWORD:
+			if (tok.keyword == KW_IF)
+				return if_expr();
+			if (tok.keyword == KW_FOR)
+				return for_expr();
+			if (tok.keyword == KW_WHILE)
+				return while_expr();
+			if (tok.keyword == KW_FUNC)
+				return func_def();
+			break;
+		default:
+			break;
 		}
 
 		// 这个错误信息，同时处理了atom和factor
-		return res.failure(make_shared<InvalidSyntaxError>(tok.pos_start, tok.pos_end, "Expected int, float, identifier, '+', '-', '(', '[', 'IF', 'FOR', 'WHILE', 'FUNC'"));
+		error("Expected int, float, identifier, '+', '-', '(', '[', 'IF', 'FOR', 'WHILE', 'FUNC'");
 	}
 
-	Parse_Result Parser::index()
+	ASTNode *Parser::index()
 	{
-		Parse_Result res;
-		shared_ptr<ASTNode> result = res.registry(atom());
-		if (res.hasError())
-			return res;
+		ASTNode *result = atom();
 
-		shared_ptr<ASTNode> index_node;
-		Token attribute;
-
-		while (isIn({TD_DOT, TD_LSQUARE}, current_tok.type))
+		while (current_tok->type == TD_DOT || current_tok->type == TD_LSQUARE)
 		{
-			if (current_tok.type == TD_LSQUARE)
+			if (current_tok->type == TD_LSQUARE)
 			{
-				res.registry_advancement();
 				advance();
 
-				index_node = res.registry(expr());
-				if (res.hasError())
-					return res;
+				ASTNode *index_node = expr();
 
-				if (current_tok.type != TD_RSQUARE)
-				{
-					return res.failure(make_shared<InvalidSyntaxError>(current_tok.pos_start, current_tok.pos_end, "Expected ']'"));
-				}
+				if (current_tok->type != TD_RSQUARE)
+					error("Expected ']'");
 
-				res.registry_advancement();
 				advance();
 
-				result = make_shared<IndexNode>(result, index_node);
+				result = arena->make<IndexNode>(result, index_node);
 			}
 			else
 			{
-				res.registry_advancement();
 				advance();
 
-				if (current_tok.type != TD_IDENTIFIER)
-				{
-					return res.failure(make_shared<InvalidSyntaxError>(current_tok.pos_start, current_tok.pos_end, "Expected an Identifier"));
-				}
-				attribute = current_tok;
+				if (current_tok->type != TD_IDENTIFIER)
+					error("Expected an Identifier");
 
-				res.registry_advancement();
+				const Token &attribute = *current_tok;
 				advance();
 
-				result = make_shared<AttrNode>(result, attribute);
+				result = arena->make<AttrNode>(result, attribute);
 			}
 		}
 
-		return res.success(result);
+		return result;
 	}
 
-	Parse_Result Parser::ref()
+	ASTNode *Parser::ref()
 	{
-		Parse_Result res;
-
-		if (current_tok.type == TD_REF)
+		if (current_tok->type == TD_REF)
 		{
-			res.registry_advancement();
 			advance();
-
-			shared_ptr<ASTNode> index_node = res.registry(index());
-
-			return res.success(make_shared<VarReferenceNode>(index_node));
+			return arena->make<VarReferenceNode>(index());
 		}
 
 		return index();
 	}
 
-	Parse_Result Parser::call()
+	ASTNode *Parser::call()
 	{
-		Parse_Result res;
-		shared_ptr<ASTNode> index_node = res.registry(ref());
-		if (res.hasError())
-			return res;
+		ASTNode *index_node = ref();
 
-		if (current_tok.type == TD_LPAREN)
-		{
-			res.registry_advancement();
-			advance();
-
-			vector<shared_ptr<ASTNode>> arg_nodes;
+		if (current_tok->type != TD_LPAREN)
+			return index_node;
 
-			if (current_tok.type == TD_RPAREN)
-			{
-				res.registry_advancement();
-				advance();
-			}
-			else
-			{
-				arg_nodes.push_back(res.registry(expr()));
-				if (res.hasError())
-				{
-					return res.failure(make_shared<InvalidSyntaxError>(current_tok.pos_start, current_tok.pos_end, "Expected ')', 'VAR', 'IF', 'FOR', 'WHILE', 'FUNC', int, float, identifier, '+', '-', '(', '[' or 'NOT'"));
-				}
-
-				while (current_tok.type == TD_COMMA)
-				{
-					res.registry_advancement();
-					advance();
+		advance();
 
-					arg_nodes.push_back(res.registry(expr()));
-					if (res.hasError())
-						return res;
-				}
+		vector<ASTNode *> arg_nodes;
 
-				if (current_tok.type != TD_RPAREN)
-				{
-					return res.failure(make_shared<InvalidSyntaxError>(current_tok.pos_start, current_tok.pos_end, "Expected ',' or ')'"));
-				}
+		if (current_tok->type != TD_RPAREN)
+		{
+			arg_nodes.push_back(expr());
 
-				res.registry_advancement();
+			while (current_tok->type == TD_COMMA)
+			{
 				advance();
+				arg_nodes.push_back(expr());
 			}
 
-			return res.success(make_shared<CallNode>(index_node, arg_nodes));
+			if (current_tok->type != TD_RPAREN)
+				error("Expected ',' or ')'");
 		}
 
-		return res.success(index_node);
+		advance();
+
+		return arena->make<CallNode>(index_node, arena->copy(arg_nodes));
 	}
 
-	Parse_Result Parser::power()
+	ASTNode *Parser::power()
 	{
-		vector<string> OPS{TD_POW};
-		return bin_op(&Parser::call, OPS, &Parser::factor);
+		ASTNode *left = call();
+
+		// 右侧为factor，因此 2^3^2 == 2^(3^2)，且允许 2^-1
+		while (current_tok->type == TD_POW)
+		{
+			const Token &op_tok = *current_tok;
+			advance();
+
+			left = arena->make<BinOpNode>(left, op_tok, factor());
+		}
+
+		return left;
 	}
 
-	Parse_Result Parser::factor()
+	ASTNode *Parser::factor()
 	{
-		Parse_Result res;
-		Token tok = this->current_tok;
+		const Token &tok = *this->current_tok;
 
 		// 一元运算，如：+5、-5
-		if (Basic::isIn({TD_PLUS, TD_MINUS}, tok.type))
+		if (tok.type == TD_PLUS || tok.type == TD_MINUS)
 		{
-			res.registry_advancement();
 			advance();
-			shared_ptr<ASTNode> fac = res.registry(factor());
-			if (res.hasError())
-				return res;
-			return res.success(make_shared<UnaryOpNode>(tok, fac));
+			return arena->make<UnaryOpNode>(tok, factor());
 		}
 
 		return power();
 	}
 
-	Parse_Result Parser::term()
+	ASTNode *Parser::binary(int min_prec)
 	{
-		vector<string> OPS{TD_MUL, TD_DIV};
-		return bin_op(&Parser::factor, OPS, &Parser::factor);
-	}
+		ASTNode *left = nullptr;
 
-	Parse_Result Parser::arith_expr()
-	{
-		vector<string> OPS{TD_PLUS, TD_MINUS};
-		return bin_op(&Parser::term, OPS, &Parser::term);
-	}
+		// 位于comp_expr的开头时才允许NOT，其作用范围是整个比较表达式
+		if (min_prec <= PREC_COMPARE)
+		{
+			if (!starts_operand(*current_tok))
+				error("Expected int, float, identifier, '+', '-', '(', '[' or 'NOT'");
 
-	Parse_Result Parser::comp_expr()
-	{
-		Parse_Result res;
+			if (current_tok->matches(KW_NOT))
+			{
+				const Token &op_tok = *current_tok;
+				advance();
+				left = arena->make<UnaryOpNode>(op_tok, binary(PREC_COMPARE));
+			}
+		}
 
-		if (this->current_tok.matches(TD_KEYWORD, "NOT"))
-		{
-			Token op_tok = this->current_tok;
+		if (left == nullptr)
+			left = factor();
 
-			res.registry_advancement();
+		// 左结合：右侧只接收优先级更高的运算符
+		for (int prec = precedence(*current_tok); prec != PREC_NONE && prec >= min_prec; prec = precedence(*current_tok))
+		{
+			const Token &op_tok = *current_tok;
 			advance();
 
-			shared_ptr<ASTNode> node = res.registry(comp_expr());
-			if (res.hasError())
-				return res;
-
-			return res.success(make_shared<UnaryOpNode>(op_tok, node));
+			left = arena->make<BinOpNode>(left, op_tok, binary(prec + 1));
 		}
 
-		vector<string> OPS{TD_EE, TD_NE, TD_LT, TD_GT, TD_LTE, TD_GTE};
-		shared_ptr<ASTNode> node = res.registry(bin_op(&Parser::arith_expr, OPS, &Parser::arith_expr));
-
-		if (res.hasError())
-			return res.failure(make_shared<InvalidSyntaxError>(current_tok.pos_start, current_tok.pos_end, "Expected int, float, identifier, '+', '-', '(', '[' or 'NOT'"));
-
-		return res.success(node);
+		return left;
 	}
 
-	Parse_Result Parser::expr()
+	ASTNode *Parser::expr()
 	{
-		Parse_Result res;
-		Position start = current_tok.pos_start;
+		Position start = current_tok->pos_start;
 
-		if (this->current_tok.matches(TD_KEYWORD, "VAR"))
-		{
-			vector <shared_ptr<ASTNode>> assignments;
-			do
-			{
-				res.registry_advancement();
-				advance();
+		if (!starts_expr(*current_tok))
+			error("Expected 'VAR', 'IF', 'FOR', 'WHILE', 'FUNC', int, float, identifier, '+', '-', '(', '[' or 'NOT'");
 
-				bool mutation = false;
-				if (this->current_tok.type == TD_REF)
-				{
-					res.registry_advancement();
-					advance();
-					mutation = true;
-				}
-
-				// 这里不同于index，要求必须以Identifier起始
-				// 所以语法中没有定义为 VAR reference = expr
-				if (this->current_tok.type != TD_IDENTIFIER)
-					return res.failure(make_shared<InvalidSyntaxError>(current_tok.pos_start, current_tok.pos_end, "Expected identifier"));
+		if (!this->current_tok->matches(KW_VAR))
+			return binary(PREC_LOGIC);
 
-				Token var_name = current_tok;
+		vector<ASTNode *> assignments;
+		do
+		{
+			advance();
 
-				shared_ptr<ASTNode> mutant = res.registry(index());
-				if (res.hasError())
-					return res;
+			bool mutation = false;
+			if (this->current_tok->type == TD_REF)
+			{
+				advance();
+				mutation = true;
+			}
 
-				if (typeid(*mutant) == typeid(IndexNode) || typeid(*mutant) == typeid(AttrNode))
-					mutation = true;
+			// 这里不同于index，要求必须以Identifier起始
+			// 所以语法中没有定义为 VAR reference = expr
+			if (this->current_tok->type != TD_IDENTIFIER)
+				error("Expected identifier");
 
-				if (this->current_tok.type != TD_EQ)
-					return res.failure(make_shared<InvalidSyntaxError>(current_tok.pos_start, current_tok.pos_end, "Expected '='"));
+			const Token &var_name = *current_tok;
 
-				res.registry_advancement();
-				advance();
+			ASTNode *mutant = index();
 
-				shared_ptr<ASTNode> exp = res.registry(expr());
-				if (res.hasError())
-					return res;
+			if (typeid(*mutant) == typeid(IndexNode) || typeid(*mutant) == typeid(AttrNode))
+				mutation = true;
 
-				if (mutation == true)
-					assignments.push_back(make_shared<MutateNode>(mutant, exp));
-				else
-					assignments.push_back(make_shared<DefineNode>(var_name, exp));
-			} while (current_tok.type == TD_COMMA);
+			if (this->current_tok->type != TD_EQ)
+				error("Expected '='");
 
-			return res.success(make_shared<VarAssignNode>(assignments, start, assignments.back()->pos_end));
-		}
+			advance();
 
-		vector<Token> LOGIC{Token(TD_KEYWORD, "AND"), Token(TD_KEYWORD, "OR")};
-		shared_ptr<ASTNode> node = res.registry(bin_op(&Parser::comp_expr, LOGIC, &Parser::comp_expr));
+			ASTNode *exp = expr();
 
-		if (res.hasError())
-			return res.failure(make_shared<InvalidSyntaxError>(current_tok.pos_start, current_tok.pos_end, "Expected 'VAR', 'IF', 'FOR', 'WHILE', 'FUNC', int, float, identifier, '+', '-', '(', '[' or 'NOT'"));
+			if (mutation == true)
+				assignments.push_back(arena->make<MutateNode>(mutant, exp));
+			else
+				assignments.push_back(arena->make<DefineNode>(var_name, exp));
+		} while (current_tok->type == TD_COMMA);
 
-		return res.success(node);
+		return arena->make<VarAssignNode>(arena->copy(assignments), start, assignments.back()->pos_end);
 	}
 
-	Parse_Result Parser::statement()
+	ASTNode *Parser::statement()
 	{
-		Parse_Result res;
-		Position start = current_tok.pos_start;
+		Position start = current_tok->pos_start;
 
-		if (current_tok.matches(TD_KEYWORD, "RETURN"))
+		if (current_tok->matches(KW_RETURN))
 		{
-			res.registry_advancement();
 			advance();
 
-			shared_ptr<ASTNode> exp = res.registry(expr());
-			if (res.hasError())
-				return res;
-
-			if (exp == nullptr)
-				reverse(res.reverse_count);
+			// 返回值可以省略
+			ASTNode *exp = starts_expr(*current_tok) ? expr() : nullptr;
 
-			return res.success(make_shared<ReturnNode>(exp, start, current_tok.pos_start));
+			return arena->make<ReturnNode>(exp, start, current_tok->pos_start);
 		}
 
-		if (current_tok.matches(TD_KEYWORD, "DEL"))
+		if (current_tok->matches(KW_DEL))
 		{
 			vector<Token> deletion;
 			do
 			{
-				res.registry_advancement();
 				advance();
 
-				if (current_tok.type != TD_IDENTIFIER)
-				{
-					return res.failure(make_shared<InvalidSyntaxError>(current_tok.pos_start, current_tok.pos_end, "Expected an identifier"));
-				}
+				if (current_tok->type != TD_IDENTIFIER)
+					error("Expected an identifier");
 
-				deletion.push_back(current_tok);
-				res.registry_advancement();
+				deletion.push_back(*current_tok);
 				advance();
+			} while (current_tok->type == TD_COMMA);
 
-			} while (current_tok.type == TD_COMMA);
-
-			return res.success(make_shared<VarDeleteNode>(deletion, start, deletion.back().pos_end));
+			return arena->make<VarDeleteNode>(arena->copy(deletion), start, deletion.back().pos_end);
 		}
 
-		if (current_tok.matches(TD_KEYWORD, "BREAK"))
+		if (current_tok->matches(KW_BREAK))
 		{
-			res.registry_advancement();
 			advance();
-
-			return res.success(make_shared<BreakNode>(start, current_tok.pos_end));
+			return arena->make<BreakNode>(start, current_tok->pos_end);
 		}
 
-		if (current_tok.matches(TD_KEYWORD, "CONTINUE"))
+		if (current_tok->matches(KW_CONTINUE))
 		{
-			res.registry_advancement();
 			advance();
-
-			return res.success(make_shared<ContinueNode>(start, current_tok.pos_end));
+			return arena->make<ContinueNode>(start, current_tok->pos_end);
 		}
 
-		shared_ptr<ASTNode> exp = res.registry(expr());
-		if (res.hasError())
-			return res.failure(make_shared<InvalidSyntaxError>(current_tok.pos_start, current_tok.pos_end, "Expected 'RETURN', 'BREAK', 'CONTINUE', 'VAR', 'IF', 'FOR', 'WHILE', 'FUNC', int, float, identifier, '+', '-', '(', '[' or 'NOT'"));
+		if (!starts_statement(*current_tok))
+			error("Expected 'RETURN', 'BREAK', 'CONTINUE', 'VAR', 'IF', 'FOR', 'WHILE', 'FUNC', int, float, identifier, '+', '-', '(', '[' or 'NOT'");
 
-		return res.success(exp);
+		return expr();
 	}
 
-	Parse_Result Parser::statements()
+	ASTNode *Parser::statements()
 	{
-		Parse_Result res;
-		Position start = this->current_tok.pos_start;
-		vector<shared_ptr<ASTNode>> statements; // a list of expression
+		Position start = this->current_tok->pos_start;
+		vector<ASTNode *> statements; // a list of expression
 
-		while (current_tok.type == TD_NEWLINE)
-		{
-			res.registry_advancement();
+		while (current_tok->type == TD_NEWLINE)
 			advance();
-		}
-
-		shared_ptr<ASTNode> statement_node = res.registry(statement());
-		if (res.hasError())
-			return res;
-
-		statements.push_back(statement_node);
 
-		bool more_statements = true;
+		statements.push_back(statement());
 
-		while (true)
+		// 语句之间以换行分隔，下一个Token不能开始一条语句时结束（如END、ELSE）
+		while (current_tok->type == TD_NEWLINE)
 		{
-			int new_linecount = 0;
-			while (current_tok.type == TD_NEWLINE)
-			{
-				res.registry_advancement();
+			while (current_tok->type == TD_NEWLINE)
 				advance();
-				new_linecount++;
-			}
-			if (new_linecount == 0)
-				more_statements = false;
 
-			if (!more_statements)
+			if (!starts_statement(*current_tok))
 				break;
 
-			// 尝试去获取一个expression
-			// 在这个过程中会使current_tok向前步进
-			// 如果失败，我们需要回退
-			statement_node = res.try_registry(statement());
-			if (statement_node == nullptr)
-			{
-				reverse(res.reverse_count);
-				more_statements = false;
-				continue;
-			}
-
-			statements.push_back(statement_node);
+			statements.push_back(statement());
 		}
 
 		if (statements.size() == 1)
-			return res.success(statements[0]);
-		else
-			return res.success(make_shared<ListNode>(statements, start, current_tok.pos_end));
-	}
-
-	Parse_Result Parser::bin_op(function<Parse_Result(Parser *)> func_a, const vector<string> &ops, function<Parse_Result(Parser *)> func_b)
-	{
-		Parse_Result res;
-		shared_ptr<ASTNode> left = res.registry(func_a(this));
-		if (res.hasError())
-			return res;
-
-		// 特化模板是为了这里比较Token.type
-		while (Basic::isIn(ops, current_tok.type))
-		{
-			Token op_tok = current_tok;
-			res.registry_advancement();
-			advance();
-
-			shared_ptr<ASTNode> right = res.registry(func_b(this));
-			if (res.hasError())
-				return res;
-
-			left = make_shared<BinOpNode>(left, op_tok, right);
-		}
-
-		return res.success(left);
-	}
-
-	Parse_Result Parser::bin_op(function<Parse_Result(Parser *)> func_a, const vector<Token> &ops, function<Parse_Result(Parser *)> func_b)
-	{
-		Parse_Result res;
-		shared_ptr<ASTNode> left = res.registry(func_a(this));
-		if (res.hasError())
-			return res;
-
-		// 特化模板是为了这里比较Token
-		while (Basic::isIn(ops, current_tok))
-		{
-			Token op_tok = current_tok;
-			res.registry_advancement();
-			advance();
-
-			shared_ptr<ASTNode> right = res.registry(func_b(this));
-			if (res.hasError())
-				return res;
-
-			left = make_shared<BinOpNode>(left, op_tok, right);
-		}
+			return statements[0];
 
-		return res.success(left);
+		return arena->make<ListNode>(arena->copy(statements), start, current_tok->pos_end);
 	}
-}
\ No newline at end of file
+}
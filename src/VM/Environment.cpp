@@ -0,0 +1,23 @@
+#include "VM/Environment.h"
+#include "Compiler/Chunk.h"
+
+namespace Basic
+{
+	Environment::Environment(const shared_ptr<Chunk> &chunk, const shared_ptr<Environment> &parent, const shared_ptr<SymbolTable> &symbols)
+	{
+		this->chunk = chunk;
+		this->parent = parent;
+		this->symbols = symbols;
+		if (chunk != nullptr)
+			this->slots.resize(chunk->local_names.size(), Value::undefined());
+	}
+
+	Environment *Environment::ancestor(uint32_t depth)
+	{
+		Environment *env = this;
+		for (uint32_t i = 0; i < depth; i++)
+			env = env->parent.get();
+
+		return env;
+	}
+}
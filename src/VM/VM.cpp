@@ -0,0 +1,756 @@
+#include "VM/VM.h"
+#include "Common/Profiler.h"
+#include "Common/utils.h"
+#include "Interpreter/MemoCache.h"
+#include <cmath>
+
+namespace Basic
+{
+	RuntimeResult VM::run(const shared_ptr<Chunk> &chunk, Context &context, const shared_ptr<Environment> &env)
+	{
+		stack.clear();
+		for_states.clear();
+		frames.clear();
+		root_chunk = chunk;
+		frames.emplace_back(chunk.get(), context, env);
+
+		RuntimeResult res = execute();
+
+		// 出错时逐层退出尚未返回的调用
+		while (!frames.empty())
+			frames.pop_back();
+		stack.clear();
+
+		return res;
+	}
+
+	RuntimeResult VM::execute()
+	{
+		RuntimeResult res;
+
+		try
+		{
+			while (true)
+			{
+				// 调用或返回后换成新的当前帧
+				Frame &frame = frames.back();
+				Chunk &ch = *frame.chunk;
+				const Instruction *code = ch.code.data();
+				Context &context = *frame.context;
+				SymbolTable &symbols = context.get_symbol_table();
+				Environment *env = frame.env.get();
+				// 顶层代码中定义的函数同样需要一个环境，引用全局符号表
+				shared_ptr<Environment> &scope = frame.scope;
+
+				if (stack.capacity() < stack.size() + ch.max_stack)
+					stack.reserve(std::max(stack.capacity() * 2, stack.size() + ch.max_stack));
+
+				size_t ip = frame.ip;
+				bool switched = false;
+
+				while (!switched)
+				{
+					size_t cur = ip++;
+					const Instruction &ins = code[cur];
+					uint32_t span = ch.span_of[cur];
+					Profiler::poll(ch.spans[span].first);
+
+					switch (ins.op)
+					{
+					case OpCode::NUMBER:
+						stack.emplace_back(ch.numbers[ins.a], span);
+						break;
+					case OpCode::CONSTANT:
+						stack.emplace_back(ch.constants[ins.a], span);
+						break;
+					case OpCode::NONE:
+						stack.emplace_back(make_Dataptr<Data>());
+						break;
+					case OpCode::POP:
+						stack.pop_back();
+						break;
+					case OpCode::GET_VAR:
+					case OpCode::GET_REF:
+					case OpCode::GET_LOCAL:
+					case OpCode::GET_LOCAL_REF:
+					{
+						DataPtr value;
+						if (ins.op == OpCode::GET_LOCAL || ins.op == OpCode::GET_LOCAL_REF)
+						{
+							Environment *frame = env->ancestor(ins.b);
+							Value &slot = frame->slots[ins.a];
+
+							if (slot.is_defined() && slot.is_number())
+							{
+								if (ins.op == OpCode::GET_LOCAL)
+								{
+									stack.emplace_back(slot.number, span);
+									break;
+								}
+
+								// 引用需要可共享、可修改的对象，装箱后放回槽位
+								slot = Value(make_Dataptr<Number>(slot.number));
+							}
+							value = slot.object;
+
+							// 槽位为空（定义之前或DEL之后）时退回按名称查找
+							if (value == nullptr)
+							{
+								const string &var_name = frame->chunk->local_names[ins.a];
+								value = symbols.get(var_name);
+								if (value == nullptr)
+									return res.failure(make_shared<RunTimeError>(ch.get_pos_start(cur), ch.get_pos_end(cur), var_name + " is not defined", context));
+							}
+						}
+						else
+						{
+							const string &var_name = ch.names[ins.a];
+							value = symbols.get(var_name);
+							if (value == nullptr)
+								return res.failure(make_shared<RunTimeError>(ch.get_pos_start(cur), ch.get_pos_end(cur), var_name + " is not defined", context));
+						}
+
+						if (ins.op == OpCode::GET_VAR || ins.op == OpCode::GET_LOCAL)
+						{
+							// 取值时Number不必拷贝，直接内联
+							if (typeid(**value) == typeid(Number))
+							{
+								stack.emplace_back(static_cast<Number *>(value->get())->get_value(), span);
+								break;
+							}
+
+							if (!(typeid(**value) == typeid(List) || typeid(**value) == typeid(Dict)))
+								value = (*value)->clone();
+						}
+
+						(*value)->set_pos(ch.get_pos_start(cur), ch.get_pos_end(cur));
+						(*value)->set_context(&context);
+						stack.emplace_back(std::move(value));
+						break;
+					}
+					case OpCode::DEFINE:
+					case OpCode::DEFINE_LOCAL:
+					{
+						bool local = ins.op == OpCode::DEFINE_LOCAL;
+						const string &var_name = local ? ch.local_names[ins.a] : ch.names[ins.a];
+
+						DataPtr cur_val;
+						if (local && env->slots[ins.a].is_defined())
+							cur_val = env->slots[ins.a].object;
+						else
+							cur_val = symbols.get(var_name);
+						if (cur_val && typeid(**cur_val) == typeid(BuiltInFunction))
+							return res.failure(make_shared<RunTimeError>(ch.get_pos_start(cur), ch.get_pos_end(cur), "Can not redefine built-in functions", context));
+
+						const Value &value = stack.back();
+						if (local && value.is_number())
+						{
+							env->slots[ins.a] = Value(value.number, value.span);
+							break;
+						}
+
+						DataPtr new_val = value.is_number() || value.pooled ? box(value, ch, context) : (*value.object)->clone();
+						if (local)
+							env->slots[ins.a] = Value(std::move(new_val));
+						else
+							symbols.set(var_name, new_val);
+						break;
+					}
+					case OpCode::SET_VAR:
+						symbols.set(ch.names[ins.a], box(stack.back(), ch, context));
+						break;
+					case OpCode::SET_LOCAL:
+					{
+						const Value &value = stack.back();
+						env->slots[ins.a] = value.is_number() ? Value(value.number, value.span) : Value(box(value, ch, context));
+						break;
+					}
+					case OpCode::MUTATE:
+					{
+						Value value = std::move(stack.back());
+						stack.pop_back();
+						DataPtr mutant = box(stack.back(), ch, context);
+
+						// 复制后再移动，保证VAR list[0] = list[1]不会使list[1]失效
+						if (value.is_number() || value.pooled)
+							*mutant = std::move(*box(value, ch, context));
+						else
+							*mutant = std::move(*(*value.object)->clone());
+
+						stack.back() = Value(std::move(mutant));
+						break;
+					}
+					case OpCode::DELETE:
+					case OpCode::DELETE_LOCAL:
+					{
+						bool local = ins.op == OpCode::DELETE_LOCAL;
+						const string &var_name = local ? ch.local_names[ins.a] : ch.names[ins.a];
+
+						bool in_slot = local && env->slots[ins.a].is_defined();
+						if (in_slot && env->slots[ins.a].is_number())
+						{
+							env->slots[ins.a] = Value::undefined();
+							break;
+						}
+
+						DataPtr value = in_slot ? env->slots[ins.a].object : symbols.get(var_name);
+						if (value == nullptr)
+							return res.failure(make_shared<RunTimeError>(ch.get_pos_start(cur), ch.get_pos_end(cur), var_name + " is not defined", context));
+
+						if (typeid(**value) == typeid(BuiltInFunction))
+							return res.failure(make_shared<RunTimeError>(ch.get_pos_start(cur), ch.get_pos_end(cur), "Can not delete built-in functions", context));
+
+						if (in_slot)
+							env->slots[ins.a] = Value::undefined();
+						else
+							symbols.remove(var_name);
+						break;
+					}
+					case OpCode::BUILD_LIST:
+					{
+						size_t first = stack.size() - ins.a;
+						vector<DataPtr> elements;
+						elements.reserve(ins.a);
+
+						for (size_t i = first; i < stack.size(); i++)
+						{
+							if (stack[i].is_number() || stack[i].pooled)
+								elements.push_back(box(stack[i], ch, context));
+							else if (!ins.b || typeid(**stack[i].object) != typeid(Data))
+								elements.push_back(std::move(stack[i].object));
+						}
+						stack.resize(first);
+
+						DataPtr result = make_Dataptr<List>(std::move(elements));
+						(*result)->set_pos(ch.get_pos_start(cur), ch.get_pos_end(cur));
+						(*result)->set_context(&context);
+						stack.emplace_back(std::move(result));
+						break;
+					}
+					case OpCode::BUILD_DICT:
+					{
+						const vector<string> &keys = ch.key_sets[ins.a];
+						size_t first = stack.size() - keys.size();
+						DictTable elements;
+						elements.reserve(keys.size());
+
+						for (size_t i = 0; i < keys.size(); i++)
+							elements[keys[i]] = box(stack[first + i], ch, context);
+						stack.resize(first);
+
+						DataPtr result = make_Dataptr<Dict>(std::move(elements));
+						(*result)->set_pos(ch.get_pos_start(cur), ch.get_pos_end(cur));
+						(*result)->set_context(&context);
+						stack.emplace_back(std::move(result));
+						break;
+					}
+					case OpCode::ADD:
+					case OpCode::SUB:
+					case OpCode::MUL:
+					case OpCode::DIV:
+					case OpCode::POW:
+					case OpCode::EE:
+					case OpCode::NE:
+					case OpCode::LT:
+					case OpCode::GT:
+					case OpCode::LTE:
+					case OpCode::GTE:
+					case OpCode::AND:
+					case OpCode::OR:
+					{
+						Value right = std::move(stack.back());
+						stack.pop_back();
+						Value &left = stack.back();
+
+						if (left.is_number() && right.is_number())
+						{
+							left = number_binop(ins, left, right, span, ch, context);
+							break;
+						}
+
+						DataPtr left_data = box(left, ch, context);
+						DataPtr right_data;
+						// 字符串的拼接与相等比较只读取右操作数，不会出错，可以直接使用常量池中的值
+						if (right.pooled && typeid(**left_data) == typeid(String) && (ins.op == OpCode::ADD || ins.op == OpCode::EE || ins.op == OpCode::NE))
+							right_data = right.object;
+						else
+							right_data = box(right, ch, context);
+						DataPtr result;
+
+						switch (ins.op)
+						{
+						case OpCode::ADD:
+							result = (*left_data)->added_to(right_data);
+							break;
+						case OpCode::SUB:
+							result = (*left_data)->subbed_by(right_data);
+							break;
+						case OpCode::MUL:
+							result = (*left_data)->multed_by(right_data);
+							break;
+						case OpCode::DIV:
+							result = (*left_data)->dived_by(right_data);
+							break;
+						case OpCode::POW:
+							result = (*left_data)->powed_by(right_data);
+							break;
+						case OpCode::EE:
+							result = (*left_data)->get_comparison_eq(right_data);
+							break;
+						case OpCode::NE:
+							result = (*left_data)->get_comparison_ne(right_data);
+							break;
+						case OpCode::LT:
+							result = (*left_data)->get_comparison_lt(right_data);
+							break;
+						case OpCode::GT:
+							result = (*left_data)->get_comparison_gt(right_data);
+							break;
+						case OpCode::LTE:
+							result = (*left_data)->get_comparison_lte(right_data);
+							break;
+						case OpCode::GTE:
+							result = (*left_data)->get_comparison_gte(right_data);
+							break;
+						case OpCode::AND:
+							result = (*left_data)->anded_by(right_data);
+							break;
+						default:
+							result = (*left_data)->ored_by(right_data);
+							break;
+						}
+
+						(*result)->set_pos(ch.get_pos_start(cur), ch.get_pos_end(cur));
+						left = Value(std::move(result));
+						break;
+					}
+					case OpCode::NEGATE:
+					case OpCode::NOT:
+					{
+						Value &value = stack.back();
+						if (value.is_number())
+						{
+							if (ins.op == OpCode::NEGATE)
+								value.number = value.number * -1;
+							else
+								value.number = value.number == 0 ? 1 : 0;
+							value.span = span;
+							break;
+						}
+
+						DataPtr operand = box(value, ch, context);
+						DataPtr result;
+						if (ins.op == OpCode::NEGATE)
+							result = (*operand)->multed_by(make_Dataptr<Number>(-1));
+						else
+							result = (*operand)->notted();
+
+						(*result)->set_pos(ch.get_pos_start(cur), ch.get_pos_end(cur));
+						value = Value(std::move(result));
+						break;
+					}
+					case OpCode::INDEX:
+					case OpCode::ATTR:
+					{
+						DataPtr result;
+						if (ins.op == OpCode::INDEX)
+						{
+							DataPtr index = box(stack.back(), ch, context);
+							stack.pop_back();
+							result = (*box(stack.back(), ch, context))->index_by(index);
+						}
+						else
+							result = (*box(stack.back(), ch, context))->attr_by(ch.attributes[ins.a]);
+
+						(*result)->set_pos(ch.get_pos_start(cur), ch.get_pos_end(cur));
+						(*result)->set_context(&context);
+						stack.back() = Value(std::move(result));
+						break;
+					}
+					case OpCode::JUMP:
+						ip = ins.a;
+						break;
+					case OpCode::JUMP_IF_FALSE:
+					{
+						const Value &value = stack.back();
+						bool condition = value.is_number() ? value.number != 0 : (*value.object)->is_true();
+						stack.pop_back();
+						if (!condition)
+							ip = ins.a;
+						break;
+					}
+					case OpCode::LIST_NEW:
+						stack.emplace_back(make_Dataptr<List>(vector<DataPtr>()));
+						break;
+					case OpCode::ACCUMULATE:
+					{
+						Value elem = std::move(stack.back());
+						stack.pop_back();
+
+						// 槽位相对于当前帧的栈底
+						vector<DataPtr> &elements = static_cast<List *>(stack[frame.stack_base + ins.a].object->get())->get_elements();
+						if (elem.is_number() || elem.pooled)
+							elements.push_back(box(elem, ch, context));
+						else if (typeid(**elem.object) != typeid(Data))
+							elements.push_back(std::move(elem.object));
+						break;
+					}
+					case OpCode::LOOP_RESULT:
+					{
+						DataPtr &result = stack.back().object;
+						if (static_cast<List *>(result->get())->size() == 0)
+							result = make_Dataptr<Data>();
+						else
+						{
+							(*result)->set_pos(ch.get_pos_start(cur), ch.get_pos_end(cur));
+							(*result)->set_context(&context);
+						}
+						break;
+					}
+					case OpCode::FOR_PREP:
+					{
+						size_t first = stack.size() - 2 - ins.b;
+						int64_t bounds[3] = {0, 0, 1};
+						for (size_t i = first; i < stack.size(); i++)
+						{
+							const Value &value = stack[i];
+							double number;
+							if (value.is_number())
+								number = value.number;
+							else if (typeid(**value.object) == typeid(Number))
+								number = static_cast<Number *>(value.object->get())->get_value();
+							else
+							{
+								DataPtr object = box(value, ch, context);
+								return res.failure(make_shared<RunTimeError>((*object)->pos_start, (*object)->pos_end, "Expect a Number", context));
+							}
+
+							if (!loop_bound(number, bounds[i - first]))
+							{
+								DataPtr object = box(value, ch, context);
+								return res.failure(make_shared<RunTimeError>((*object)->pos_start, (*object)->pos_end, "Loop bound out of range", context));
+							}
+						}
+
+						ForState state;
+						state.i = bounds[0];
+						state.end = bounds[1];
+						state.step = bounds[2];
+						state.done = false;
+						for_states.push_back(state);
+
+						stack.resize(first);
+
+						// 需要收集结果时，下方是LIST_NEW生成的列表
+						if (ins.a)
+						{
+							List *result = static_cast<List *>(stack.back().object->get());
+							result->get_elements().reserve(loop_count(state.i, state.end, state.step));
+						}
+						break;
+					}
+					case OpCode::FOR_LOCAL:
+					case OpCode::FOR_VAR:
+					{
+						ForState &state = for_states.back();
+
+						// 步长可以是负的
+						if (state.done || (state.step >= 0 ? state.i > state.end : state.i < state.end))
+						{
+							ip = ins.a;
+							break;
+						}
+
+						// 全局的循环变量未被改为其他值或被引用时原地更新
+						if (ins.op == OpCode::FOR_LOCAL)
+							env->slots[ins.b] = Value((double)state.i, span);
+						else
+						{
+							DataPtr *cell = symbols.find(ch.names[ins.b]);
+							if (cell != nullptr)
+								Number::assign(*cell, state.i);
+							else
+								symbols.set(ch.names[ins.b], make_Dataptr<Number>(state.i));
+						}
+						state.done = !loop_advance(state.i, state.step);
+						break;
+					}
+					case OpCode::FOR_END:
+						for_states.pop_back();
+						break;
+					case OpCode::MAKE_FUNCTION:
+					{
+						const FunctionProto &proto = ch.functions[ins.a];
+						if (scope == nullptr)
+							scope = make_shared<Environment>(root_chunk, nullptr, context.get_shared_symbol_table());
+
+						DataPtr func = make_Dataptr<Function>(proto.name, nullptr, nullptr, proto.arg_names, proto.auto_return, proto.chunk, scope);
+						(*func)->set_pos(ch.get_pos_start(cur), ch.get_pos_end(cur));
+						(*func)->set_context(&context);
+
+						stack.emplace_back(std::move(func));
+						break;
+					}
+					case OpCode::CALL:
+					case OpCode::TAIL_CALL:
+					{
+						size_t first = stack.size() - ins.a;
+						vector<DataPtr> args;
+						args.reserve(ins.a);
+						for (size_t i = first; i < stack.size(); i++)
+							args.push_back(box(stack[i], ch, context));
+						stack.resize(first);
+
+						DataPtr value_to_call = box(stack.back(), ch, context);
+						(*value_to_call)->set_pos(ch.get_pos_start(cur), ch.get_pos_end(cur));
+
+						bool tail = ins.op == OpCode::TAIL_CALL;
+						DataPtr callee = value_to_call;
+						DataPtr return_value;
+
+						// MEMO函数：命中时直接取缓存的结果，否则调用其中的函数，返回时写入缓存
+						shared_ptr<MemoCache> memo;
+						string memo_key;
+						if (typeid(**callee) == typeid(MemoFunction))
+						{
+							MemoFunction *memo_func = raw_Dataptr<MemoFunction>(callee);
+							if (raw_Dataptr<Function>(memo_func->get_func())->is_compiled() && MemoCache::make_key(args, memo_key))
+							{
+								return_value = memo_func->get_cache()->get(memo_key);
+								if (return_value != nullptr)
+									return_value = (*return_value)->clone();
+								else
+								{
+									memo = memo_func->get_cache();
+									callee = memo_func->get_func();
+								}
+							}
+						}
+
+						if (return_value == nullptr && typeid(**callee) == typeid(Function) && raw_Dataptr<Function>(callee)->is_compiled())
+						{
+							// 最外层帧中的尾调用交给Function::execute，在那里接着执行
+							if (tail && memo == nullptr && frames.size() == 1)
+								return res.success_tail_call(callee, std::move(args));
+
+							frame.ip = ip;
+							Context *parent = &context;
+							Position call_pos = ch.get_pos_start(cur);
+							// 尾调用会先弹出当前帧，其chunk随之可能被释放，调用处的位置需先取出
+							Position call_start = ch.get_pos_start(cur);
+							Position call_end = ch.get_pos_end(cur);
+
+							// 尾调用换掉当前帧，新帧的调用者仍是当前帧的调用者
+							// 最外层帧不能换掉，此时与普通调用相同，其后的RETURN/HALT会返回结果
+							// MEMO调用的帧也不能换掉，否则返回时无法将结果写入缓存
+							if (tail && frames.size() > 1 && frame.memo() == nullptr)
+							{
+								parent = context.get_parent();
+								call_pos = context.get_parent_entry_pos();
+								drop_frame();
+							}
+
+							RuntimeResult call_result = push_frame(callee, args, *parent, call_pos, call_start, call_end);
+							if (call_result.hasError())
+								return res.failure(call_result.getError());
+
+							if (memo != nullptr)
+							{
+								unique_ptr<FrameExtra> &extra = frames.back().extra;
+								if (extra == nullptr)
+									extra = make_unique<FrameExtra>();
+								extra->memo = std::move(memo);
+								extra->memo_key = std::move(memo_key);
+							}
+							switched = true;
+							break;
+						}
+
+						if (return_value == nullptr)
+						{
+							RuntimeResult call_result = (*callee)->execute(args);
+							if (call_result.hasError())
+								return res.failure(call_result.getError());
+							return_value = call_result.getValuePtr();
+						}
+
+						if (typeid(**return_value) == typeid(Number))
+						{
+							stack.back() = Value(static_cast<Number *>(return_value->get())->get_value(), span);
+							break;
+						}
+
+						(*return_value)->set_pos(ch.get_pos_start(cur), ch.get_pos_end(cur));
+						(*return_value)->set_context(&context);
+						stack.back() = Value(std::move(return_value));
+						break;
+					}
+					case OpCode::RETURN:
+					case OpCode::HALT:
+					{
+						DataPtr value = box(stack.back(), ch, context);
+						stack.pop_back();
+
+						if (frames.size() == 1)
+							return ins.op == OpCode::RETURN ? res.success_return(value) : res.success(value);
+
+						pop_frame(std::move(value), ins.op == OpCode::RETURN);
+						switched = true;
+						break;
+					}
+					}
+				}
+			}
+		}
+		catch (RunTimeError &e)
+		{
+			return res.failure(make_shared<RunTimeError>(e));
+		}
+	}
+
+	VM::Frame::Frame(Chunk *chunk, Context &context, const shared_ptr<Environment> &env)
+	{
+		this->chunk = chunk;
+		this->env = env;
+		this->scope = env;
+		this->context = &context;
+	}
+
+	VM::Frame::Frame(const DataPtr &callee, Function *func, Context &context, const Position &call_pos, size_t stack_base, size_t for_base)
+	{
+		if (Profiler::active() || Tracer::active())
+		{
+			this->extra = make_unique<FrameExtra>();
+			this->extra->profile_scope.emplace(func->get_func_name(), call_pos);
+			this->extra->trace_scope.emplace("function", func->get_func_name(), call_pos);
+		}
+		Stats::function_called();
+
+		this->callee = callee;
+		this->chunk = func->get_chunk().get();
+		this->context = &context;
+		this->stack_base = stack_base;
+		this->for_base = for_base;
+		this->auto_return = func->is_auto_return();
+	}
+
+	RuntimeResult VM::push_frame(const DataPtr &callee, vector<DataPtr> &args, Context &parent, const Position &call_pos, const Position &call_start, const Position &call_end)
+	{
+		RuntimeResult res;
+		Function *func = raw_Dataptr<Function>(callee);
+
+		if (parent.get_depth() >= Context::get_max_depth())
+			return res.failure(make_shared<RunTimeError>(call_start, call_end, "Maximum recursion depth exceeded", parent));
+
+		// 每次调用使用新的Context，随帧一起弹出
+		// 符号表暂用调用者的，bind随即换成本次调用的，避免多分配一个空表
+		contexts.emplace_back(func->get_func_name(), &parent, call_pos, parent.get_shared_symbol_table());
+		Context &call_context = contexts.back();
+
+		frames.emplace_back(callee, func, call_context, call_pos, stack.size(), for_states.size());
+		Frame &frame = frames.back();
+
+		res.registry(func->bind(args, call_context, frame.env, call_start, call_end));
+		if (res.hasError())
+		{
+			drop_frame();
+			return res;
+		}
+
+		frame.scope = frame.env;
+		return res.success(nullptr);
+	}
+
+	void VM::pop_frame(DataPtr value, bool explicit_return)
+	{
+		Frame &frame = frames.back();
+
+		// 与Function::execute一致：多行函数没有RETURN时返回空
+		if (!frame.auto_return && !explicit_return)
+			value = make_Dataptr<Data>();
+
+		if (frame.memo() != nullptr)
+			frame.extra->memo->put(frame.extra->memo_key, (*value)->clone());
+
+		drop_frame();
+
+		// 结果替换调用者栈顶的函数，位置记为调用处
+		Frame &caller = frames.back();
+		Chunk &ch = *caller.chunk;
+		size_t cur = caller.ip - 1;
+
+		if (typeid(**value) == typeid(Number))
+		{
+			stack.back() = Value(static_cast<Number *>(value->get())->get_value(), ch.span_of[cur]);
+			return;
+		}
+
+		(*value)->set_pos(ch.get_pos_start(cur), ch.get_pos_end(cur));
+		(*value)->set_context(caller.context);
+		stack.back() = Value(std::move(value));
+	}
+
+	void VM::drop_frame()
+	{
+		Frame &frame = frames.back();
+		stack.resize(frame.stack_base);
+		for_states.resize(frame.for_base);
+
+		if (frames.size() > 1)
+			contexts.pop_back();
+		frames.pop_back();
+	}
+
+	DataPtr VM::box(const Value &value, Chunk &chunk, Context &context)
+	{
+		if (!value.is_number() && !value.pooled)
+			return value.object;
+
+		const pair<Position, Position> &pos = chunk.spans[value.span];
+		if (value.is_number())
+			return make_Dataptr<Number>(value.number, pos.first, pos.second, &context);
+
+		DataPtr object = (*value.object)->clone();
+		(*object)->set_pos(pos.first, pos.second);
+		(*object)->set_context(&context);
+		return object;
+	}
+
+	Value VM::number_binop(const Instruction &ins, const Value &left, const Value &right, uint32_t span, Chunk &chunk, Context &context)
+	{
+		double a = left.number;
+		double b = right.number;
+
+		switch (ins.op)
+		{
+		case OpCode::ADD:
+			return Value(a + b, span);
+		case OpCode::SUB:
+			return Value(a - b, span);
+		case OpCode::MUL:
+			return Value(a * b, span);
+		case OpCode::DIV:
+			if (b == 0)
+				throw RunTimeError(chunk.spans[right.span].first, chunk.spans[right.span].second, "Division by 0", context);
+			return Value(a / b, span);
+		case OpCode::POW:
+			return Value(pow(a, b), span);
+		case OpCode::EE:
+			return Value(a == b, span);
+		case OpCode::NE:
+			return Value(a != b, span);
+		case OpCode::LT:
+			return Value(a < b, span);
+		case OpCode::GT:
+			return Value(a > b, span);
+		case OpCode::LTE:
+			return Value(a <= b, span);
+		case OpCode::GTE:
+			return Value(a >= b, span);
+		case OpCode::AND:
+			return Value((int)a & (int)b, span);
+		default:
+			return Value((int)a | (int)b, span);
+		}
+	}
+}
@@ -4,20 +4,36 @@
 #include "Lexer/Lexer.h"
 #include "Parser/Parser.h"
 #include "Interpreter/Interpreter.h"
+#include "Parser/InvalidSyntaxError.h"
+#include "Compiler/Compiler.h"
+#include "Compiler/ConstantFolder.h"
+#include "Compiler/ResultElider.h"
+#include "Compiler/TailCallMarker.h"
+#include "Compiler/ScriptCache.h"
+#include "Compiler/Serializer.h"
+#include "Common/MappedFile.h"
+#include "Common/Profiler.h"
+#include "Common/Tracer.h"
+#include "VM/VM.h"
 
 using namespace std;
 using namespace Basic;
 
 Context context("<program>");
 bool DEBUG = false;
+bool TREE_WALK = false; // 使用树遍历解释器代替字节码虚拟机
+bool OPTIMIZE = true;	 // 常量折叠与常量池，调试时可关闭
 
-tuple<DataPtr, shared_ptr<Error>> Basic::run(const string &filename, const string &text)
+// 词法与语法分析，字节码模式下再编译为Chunk
+// keep_value为假时程序的值不会被使用，不收集语句层面循环的结果
+static shared_ptr<Error> compile(const string &filename, const string &text, Program &program, bool keep_value = false)
 {
 	// LexicalAnalysis
 	Lexer lexer(filename, text);
 	vector<Token> lex_result;
 	try
 	{
+		Tracer::Scope trace_scope("phase", "lex");
 		lex_result = lexer.make_tokens();
 		if (DEBUG)
 		{
@@ -31,41 +47,92 @@ tuple<DataPtr, shared_ptr<Error>> Basic::run(const string &filename, const strin
 	}
 	catch (IllegalCharError &e)
 	{
-		return make_tuple(nullptr, make_shared<IllegalCharError>(e));
+		return make_shared<IllegalCharError>(e);
 	}
 	catch (ExpectCharError &e)
 	{
-		return make_tuple(nullptr, make_shared<ExpectCharError>(e));
+		return make_shared<ExpectCharError>(e);
 	}
 
 	// 当为注释时，仅有EOF
 	if (lex_result.size() <= 1)
-		return make_tuple(nullptr, nullptr);
+		return nullptr;
 
 	// Parsing
-	Parser parse(lex_result);
-	lex_result.clear();
+	Parser parse(std::move(lex_result));
+	try
+	{
+		Tracer::Scope trace_scope("phase", "parse");
+		program.root = parse.parse();
+	}
+	catch (InvalidSyntaxError &e)
+	{
+		return make_shared<InvalidSyntaxError>(e);
+	}
+
+	if (OPTIMIZE)
+	{
+		Tracer::Scope trace_scope("phase", "fold");
+		program.root = ConstantFolder(parse.get_arena(), TREE_WALK).fold(program.root);
+	}
 
-	Parse_Result res = parse.parse();
-	shared_ptr<ASTNode> root = res.getNode();
-	shared_ptr<Error> err = res.getError();
+	ResultElider().elide(program.root, keep_value);
+	TailCallMarker().mark(program.root);
 
-	if (err != nullptr)
+	if (DEBUG)
 	{
-		return make_tuple(nullptr, err);
+		cout << program.root->repr() << endl;
 	}
 
+	if (TREE_WALK)
+	{
+		program.arena = parse.get_arena();
+		return nullptr;
+	}
+
+	try
+	{
+		Tracer::Scope trace_scope("phase", "compile");
+		program.chunk = Compiler().compile(program.root);
+	}
+	catch (InvalidSyntaxError &e)
+	{
+		return make_shared<InvalidSyntaxError>(e);
+	}
+
+	// 字节码模式不再需要语法树，随Parser一同释放
+	program.root = nullptr;
+
 	if (DEBUG)
 	{
-		cout << root->repr() << endl;
+		cout << program.chunk->disassemble() << endl;
 	}
 
+	return nullptr;
+}
+
+static tuple<DataPtr, shared_ptr<Error>> execute(const Program &program)
+{
 	// Interpret
-	Interpreter interpreter;
-	RuntimeResult interprete_result = interpreter.visit(root, context);
+	Tracer::Scope trace_scope("phase", "interpret");
+	RuntimeResult interprete_result;
+	if (program.chunk != nullptr)
+	{
+		VM vm;
+		interprete_result = vm.run(program.chunk, context);
+	}
+	else if (program.root != nullptr)
+	{
+		Interpreter interpreter(program.arena);
+		interprete_result = interpreter.visit(program.root, context);
+	}
+	else
+	{
+		return make_tuple(nullptr, nullptr);
+	}
 
 	DataPtr data = interprete_result.getValuePtr();
-	err = interprete_result.getError();
+	shared_ptr<Error> err = interprete_result.getError();
 
 	if (err != nullptr)
 	{
@@ -79,6 +146,140 @@ tuple<DataPtr, shared_ptr<Error>> Basic::run(const string &filename, const strin
 	return make_tuple(nullptr, nullptr);
 }
 
+tuple<DataPtr, shared_ptr<Error>> Basic::run(const string &filename, const string &text, bool keep_value)
+{
+	Tracer::Scope trace_scope("script", filename);
+	Program program;
+	shared_ptr<Error> err = compile(filename, text, program, keep_value);
+	if (err != nullptr)
+		return make_tuple(nullptr, err);
+
+	return execute(program);
+}
+
+std::optional<tuple<DataPtr, shared_ptr<Error>>> Basic::run_file(const string &file_path)
+{
+	Tracer::Scope trace_scope("script", file_path);
+	ScriptCache::Stamp stamp;
+	if (!ScriptCache::stat(file_path, stamp))
+		return std::nullopt;
+
+	Program program;
+	if (ScriptCache::find(file_path, stamp, program))
+	{
+		trace_scope.detail("cached");
+	}
+	else
+	{
+		auto text = readfile(file_path);
+		if (!text.has_value())
+			return std::nullopt;
+
+		uint64_t hash = ScriptCache::hash(text.value());
+		if (ScriptCache::find(file_path, stamp, hash, program))
+		{
+			trace_scope.detail("cached");
+		}
+		else
+		{
+			if (!TREE_WALK)
+				program.chunk = ScriptCache::load_disk(file_path, hash);
+
+			if (program.chunk != nullptr)
+			{
+				trace_scope.detail("disk cache");
+			}
+			else
+			{
+				trace_scope.detail("compiled");
+				// 有错误的脚本不缓存，下次重新报告
+				shared_ptr<Error> err = compile(file_path, text.value(), program);
+				if (err != nullptr)
+					return make_tuple(nullptr, err);
+
+				if (program.chunk != nullptr)
+					ScriptCache::save_disk(file_path, hash, text.value(), *program.chunk);
+			}
+
+			ScriptCache::store(file_path, stamp, hash, program);
+		}
+	}
+
+	return execute(program);
+}
+
+// 将脚本编译为字节码文件，不执行
+static bool compile_file(const string &file_path, const string &out_path)
+{
+	auto text = readfile(file_path);
+	if (!text.has_value())
+	{
+		cout << "Fatal: cannot load script\n";
+		return false;
+	}
+
+	Program program;
+	shared_ptr<Error> err = compile(file_path, text.value(), program);
+	if (err != nullptr)
+	{
+		cout << err->as_string() << "\n";
+		return false;
+	}
+
+	if (program.chunk == nullptr)
+	{
+		cout << "Fatal: script has nothing to compile\n";
+		return false;
+	}
+
+	string data;
+	if (!Serializer::save(*program.chunk, file_path, text.value(), ScriptCache::hash(text.value()), data))
+	{
+		cout << "Fatal: cannot serialize script\n";
+		return false;
+	}
+
+	std::ofstream ofs(out_path, std::ios::binary | std::ios::trunc);
+	ofs.write(data.data(), data.size());
+	if (!ofs)
+	{
+		cout << "Fatal: cannot write " << out_path << "\n";
+		return false;
+	}
+	return true;
+}
+
+// 映射并执行--compile生成的字节码文件；文件无法加载时返回false
+static bool exec_file(const string &path)
+{
+	Tracer::Scope trace_scope("script", path);
+	trace_scope.detail("bytecode file");
+	MappedFile file;
+	if (!file.open(path))
+	{
+		cout << "Fatal: cannot load " << path << "\n";
+		return false;
+	}
+
+	uint64_t source_hash;
+	Program program;
+	program.chunk = Serializer::load(file.data(), source_hash);
+	file.close();
+
+	if (program.chunk == nullptr)
+	{
+		cout << "Fatal: " << path << " is not a valid bytecode file\n";
+		return false;
+	}
+
+	auto result = execute(program);
+	if (std::get<1>(result) != nullptr)
+	{
+		cout << std::get<1>(result)->as_string() << "\n";
+	}
+	return true;
+}
+
 void Init()
 {
 	SymbolTable &global_symbol_table = context.get_symbol_table();
@@ -111,6 +312,9 @@ void Init()
 	global_symbol_table.set("POP_FRONT", make_Dataptr<BuiltInFunction>("POP_FRONT"));
 	global_symbol_table.set("EXTEND", make_Dataptr<BuiltInFunction>("EXTEND"));
 	global_symbol_table.set("SWAP", make_Dataptr<BuiltInFunction>("SWAP"));
+	global_symbol_table.set("STATS", make_Dataptr<BuiltInFunction>("STATS"));
+	global_symbol_table.set("MEMO", make_Dataptr<BuiltInFunction>("MEMO"));
+	global_symbol_table.set("MEMO_STATS", make_Dataptr<BuiltInFunction>("MEMO_STATS"));
 
 	crossline_completion_register(Basic::completion_hook);
 	crossline_history_load("history.txt");
@@ -142,7 +346,7 @@ void doREPL()
 				text.append(tmp);
 			}
 
-			auto result = Basic::run("<stdin>", text);
+			auto result = Basic::run("<stdin>", text, true);
 			if (std::get<1>(result) != nullptr)
 			{
 				cout << std::get<1>(result)->as_string() << "\n";
@@ -165,6 +369,15 @@ struct MyArgs : public argparse::Args
 	bool &interactive = flag("i", "A flag to toggle interactive mode");
 	bool &verbose = flag("v,verbose", "A flag to toggle verbose");
 	bool &debug = flag("D,Debug", "A flag to toggle debug mode");
+	bool &tree = flag("T,tree", "A flag to use the tree-walking interpreter instead of the bytecode VM");
+	bool &no_opt = flag("no-opt", "A flag to disable constant folding and the constant pool");
+	std::optional<string> &cache = kwarg("cache", "Directory to keep compiled scripts in, reused by later runs");
+	std::optional<string> &compile = kwarg("compile", "Compile the script given by -f into a bytecode file instead of running it");
+	std::optional<string> &exec = kwarg("exec", "Execute a bytecode file produced by --compile");
+	std::optional<string> &trace = kwarg("trace", "Record phases and calls as Chrome trace events (Perfetto, chrome://tracing) into the given file");
+	std::optional<long> &max_depth = kwarg("max-depth", "Maximum depth of nested function calls before a runtime error is raised (default 100000; with -T also bounded by the native stack size, about 2600 calls under an 8 MB stack)");
+	bool &stats = flag("stats", "A flag to print runtime counters (allocations, clones, lookups, calls) at exit");
+	std::optional<string> &profile = kwarg("profile", "Sample the script, print a per-function/per-line report and write collapsed stacks to the given file", "profile.folded");
 
 	void welcome() override
 	{
@@ -172,9 +385,18 @@ struct MyArgs : public argparse::Args
 	}
 };
 
-void ParseArgs(int argc, char *argv[])
+// 返回进程退出码，出现Fatal错误时非0
+int ParseArgs(int argc, char *argv[])
 {
 	MyArgs args = argparse::parse<MyArgs>(argc, argv);
+	int status = 0;
+
+	// --exec运行的是独立的字节码文件，不能与另一个脚本同时给出
+	if (args.exec.has_value() && (args.src_path.has_value() || args.compile.has_value()))
+	{
+		cout << "Fatal: --exec cannot be combined with -f or --compile\n";
+		return 1;
+	}
 
 	if (args.verbose)
 		args.print();
@@ -182,24 +404,60 @@ void ParseArgs(int argc, char *argv[])
 	if (args.debug)
 		DEBUG = true;
 
-	if (args.src_path.has_value())
+	if (args.tree)
+		TREE_WALK = true;
+
+	if (args.no_opt)
+		OPTIMIZE = false;
+
+	if (args.max_depth.has_value() && args.max_depth.value() > 0)
+		Context::set_max_depth(args.max_depth.value());
+
+	if (args.cache.has_value())
+		ScriptCache::set_disk_dir(args.cache.value());
+
+	if (args.profile.has_value())
+		Profiler::start();
+
+	if (args.trace.has_value())
+		Tracer::start();
+
+	if (args.compile.has_value())
+	{
+		if (!args.src_path.has_value())
+		{
+			cout << "Fatal: --compile needs a script given by -f\n";
+			status = 1;
+		}
+		else if (TREE_WALK)
+		{
+			cout << "Fatal: --compile produces bytecode and cannot be used with -T\n";
+			status = 1;
+		}
+		else if (!compile_file(args.src_path.value(), args.compile.value()))
+			status = 1;
+	}
+	else if (args.src_path.has_value())
 	{
 		string file = args.src_path.value();
-		auto text = readfile(file);
-		if (text.has_value())
+		auto result = run_file(file);
+		if (result.has_value())
 		{
-			auto result = run(file, text.value());
-			if (std::get<1>(result) != nullptr)
+			if (std::get<1>(result.value()) != nullptr)
 			{
-				cout << std::get<1>(result)->as_string() << "\n";
+				cout << std::get<1>(result.value())->as_string() << "\n";
 			}
 		}
 		else
 		{
 			cout << "Fatal: cannot load script\n";
+			status = 1;
 		}
 	}
 
+	if (args.exec.has_value() && !exec_file(args.exec.value()))
+		status = 1;
+
 	if (args.text.has_value())
 	{
 		auto result = run("<stdin>", args.text.value());
@@ -209,18 +467,43 @@ void ParseArgs(int argc, char *argv[])
 		}
 	}
 
+	if (args.trace.has_value() && !Tracer::write(args.trace.value()))
+	{
+		std::cerr << "Fatal: cannot write " << args.trace.value() << "\n";
+		status = 1;
+	}
+
+	if (args.stats)
+		Stats::dump(std::cerr);
+
+	if (args.profile.has_value())
+	{
+		Profiler::stop();
+		Profiler::report(std::cerr);
+		if (!Profiler::write_collapsed(args.profile.value()))
+		{
+			std::cerr << "Fatal: cannot write " << args.profile.value() << "\n";
+			status = 1;
+		}
+	}
+
 	if (args.interactive)
 		doREPL();
+
+	return status;
 }
 
 int main(int argc, char *argv[])
 {
+	// 树遍历解释器的调用在C++栈上递归，可达的深度由实际的栈大小决定
+	Context::mark_stack_base();
 	Init();
 
 	if (argc == 1)
+	{
 		doREPL();
-	else
-		ParseArgs(argc, argv);
+		return 0;
+	}
 
-	return 0;
+	return ParseArgs(argc, argv);
 }
\ No newline at end of file